@@ -0,0 +1,354 @@
+/**
+	AllocCheck.cpp
+		Checks that drawing a frame allocates nothing: the global operator
+	new and delete are replaced by counting ones, the menus are walked
+	through and a game is played, moving the cursor, flagging and jumping
+	along the frontier, with the headless, the text and the ncurses
+	interfaces (the last one on a pseudo-terminal, as its standard input
+	and output). The allocations are counted at every menu and board
+	drawn; once the first ones are drawn (the first reveal places the
+	bombs, the buffers grow to the board) the count must not change any
+	more. Switching between the menu and the game screens is not checked,
+	it lays the windows out again.
+
+	Usage: './alloc_check' (or 'make alloc-check'), exits with 1 if a
+	frame allocated.
+
+	@author Sergiu Constantinescu
+*/
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <unistd.h>
+#include "GameState.h"
+#include "GameSettings.h"
+#include "MainMenu.h"
+#include "IOText.h"
+#include "IOScript.h"
+#include "IOLinux.h"
+#include "Utils.h"
+
+// frames drawn before the allocations have to stop, and frames checked
+#define WARM_UP_FRAMES	16
+#define CHECKED_FRAMES	2000
+#define CHECK_SEED		7
+#define CHECK_DIFF		3
+// keys the terminal is sent ahead of the frames drawn, well within the
+// input it holds
+#define KEYS_AHEAD		64
+
+
+static std::atomic<uint64_t> allocations(0);
+// menus and boards drawn by any interface, for the keys sent to the terminal
+static std::atomic<uint64_t> frames(0);
+// set once the game is over, the keys left are not read any more
+static std::atomic<bool> session_over(false);
+
+void* operator new(size_t size) {
+	allocations ++;
+	void* p = malloc(size == 0 ? 1 : size);
+	if(p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	allocations ++;
+	return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept {
+	free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	free(p);
+}
+
+// the allocations counted when every frame was drawn; the room is made
+// beforehand, so recording allocates nothing
+struct frame_log {
+	std::vector<uint64_t> counts;
+
+	frame_log() { counts.reserve(CHECKED_FRAMES * 2); }
+
+	void record() {
+		if(counts.size() < counts.capacity()) {
+			counts.push_back(allocations);
+		}
+		frames ++;
+	}
+};
+
+class CountingText : public IOText {
+public:
+	frame_log log;
+	frame_log menu_log;
+
+	CountingText(GameSettings* settings) : IOText(settings) {}
+
+	void print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y,
+						int marked, double percent) {
+		IOText::print_board(visible_field, c_x, c_y, marked, percent);
+		log.record();
+	}
+
+	void print_menu(int menu_level) {
+		IOText::print_menu(menu_level);
+		menu_log.record();
+	}
+};
+
+class CountingScript : public IOScript {
+public:
+	frame_log log;
+
+	CountingScript(GameSettings* settings) : IOScript(settings) {}
+
+	// no key is pending when a frame is due, so every key makes a frame
+	char poll_char() {
+		return 0;
+	}
+
+	void print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y,
+						int marked, double percent) {
+		IOScript::print_board(visible_field, c_x, c_y, marked, percent);
+		log.record();
+	}
+};
+
+class CountingLinux : public IOLinux {
+public:
+	frame_log log;
+	frame_log menu_log;
+
+	CountingLinux(GameSettings* settings) : IOLinux(settings) {}
+
+	// no key is pending when a frame is due, so every key makes a frame
+	char poll_char() {
+		return 0;
+	}
+
+	void print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y,
+						int marked, double percent) {
+		IOLinux::print_board(visible_field, c_x, c_y, marked, percent);
+		log.record();
+	}
+
+	void print_menu(int menu_level) {
+		IOLinux::print_menu(menu_level);
+		menu_log.record();
+	}
+};
+
+// the keys of the game: the first reveal, then moves, flags put and taken
+// back and jumps along the frontier, which leave the board as it was
+std::vector<char> make_keys() {
+	const char* round = "dsawesenbeawdb";
+	std::vector<char> keys;
+	keys.push_back(' ');
+	while(keys.size() < WARM_UP_FRAMES + CHECKED_FRAMES) {
+		for(const char* k = round; *k != '\0'; k ++) {
+			keys.push_back(*k);
+		}
+	}
+	return keys;
+}
+
+// the keys of the menus, every one of them but the prompts, which leave
+// the settings as they were, then a new game
+std::vector<char> make_menu_keys() {
+	// options, rules, back, difficulty, no-guess on and off, back, back
+	const char* round = "21126683";
+	std::vector<char> keys;
+	while(keys.size() < WARM_UP_FRAMES + CHECKED_FRAMES) {
+		for(const char* k = round; *k != '\0'; k ++) {
+			keys.push_back(*k);
+		}
+	}
+	keys.push_back('1');
+	return keys;
+}
+
+// the menu keys, the game keys and the quit confirmation
+std::vector<char> make_session_keys() {
+	std::vector<char> keys = make_menu_keys();
+	std::vector<char> game = make_keys();
+	keys.insert(keys.end(), game.begin(), game.end());
+	keys.push_back('q');
+	keys.push_back('y');
+	return keys;
+}
+
+// sends the keys to the terminal, never more than KEYS_AHEAD ahead of
+// the frames drawn
+void feed_keys(int terminal, const std::vector<char>* keys) {
+	for(size_t k = 0; k < keys->size(); k ++) {
+		while(k > frames + KEYS_AHEAD) {
+			if(session_over) {
+				return;
+			}
+			usleep(100);
+		}
+		if(write(terminal, &(*keys)[k], 1) != 1) {
+			return;
+		}
+	}
+}
+
+// reads what the game draws, until the terminal is closed
+void drain_output(int terminal) {
+	char buf[4096];
+	while(read(terminal, buf, sizeof(buf)) > 0) {
+	}
+}
+
+// false if a frame after the first ones allocated
+bool report(const char* name, const frame_log& log) {
+	const std::vector<uint64_t>& counts = log.counts;
+	if(counts.size() <= WARM_UP_FRAMES) {
+		std::cout << name << ": only " << counts.size() << " frames drawn"
+					<< std::endl;
+		return false;
+	}
+
+	uint64_t base = counts[WARM_UP_FRAMES - 1];
+	uint64_t bad = 0;
+	for(size_t f = WARM_UP_FRAMES; f < counts.size(); f ++) {
+		bad += counts[f] != counts[f - 1];
+	}
+	std::cout << name << ": " << counts.size() - WARM_UP_FRAMES
+				<< " frames after warm-up, " << counts.back() - base
+				<< " allocations, " << bad << " frames allocating" << std::endl;
+	return bad == 0;
+}
+
+int main() {
+	std::vector<char> keys = make_keys();
+	GameSettings settings;
+	settings.set_diff(CHECK_DIFF);
+	bool ok = true;
+
+	// the headless interface plays the keys as a script
+	{
+		settings.set_seed(CHECK_SEED);
+		CountingScript io_script(&settings);
+		io_script.load_string(std::string(keys.begin(), keys.end()));
+		GameState<CountingScript> game_state(&io_script);
+		game_state.game_loop(&settings);
+		ok = report("IOScript", io_script.log) && ok;
+	}
+
+	// the text interface reads a key per line, so every key makes a frame,
+	// and its frames go to /dev/null
+	{
+		std::vector<char> session = make_session_keys();
+		std::string lines;
+		for(size_t k = 0; k < session.size(); k ++) {
+			lines.push_back(session[k]);
+			lines.push_back('\n');
+		}
+		std::istringstream input(lines);
+		std::streambuf* old_input = std::cin.rdbuf(input.rdbuf());
+		int old_output = dup(STDOUT_FILENO);
+		int null_output = open("/dev/null", O_WRONLY);
+		dup2(null_output, STDOUT_FILENO);
+
+		settings.set_seed(CHECK_SEED);
+		CountingText io_text(&settings);
+		MainMenu<CountingText> main_menu(&io_text);
+		GameState<CountingText> game_state(&io_text);
+		if(main_menu.menu_loop(&settings) == 0) {
+			game_state.game_loop(&settings);
+		}
+
+		dup2(old_output, STDOUT_FILENO);
+		close(null_output);
+		close(old_output);
+		std::cin.rdbuf(old_input);
+		ok = report("IOText menu", io_text.menu_log) && ok;
+		ok = report("IOText", io_text.log) && ok;
+	}
+
+	// the ncurses interface runs on a pseudo-terminal, which is sent the
+	// keys as they are read and whose screen is thrown away
+	{
+		struct winsize ws;
+		memset(&ws, 0, sizeof(ws));
+		ws.ws_row = 40;
+		ws.ws_col = 100;
+		int master, slave;
+		if(openpty(&master, &slave, NULL, NULL, &ws) < 0) {
+			std::cout << "IOLinux: no pseudo-terminal" << std::endl;
+			return 1;
+		}
+		if(getenv("TERM") == NULL) {
+			setenv("TERM", "xterm", 1);
+		}
+		int old_input = dup(STDIN_FILENO);
+		int old_output = dup(STDOUT_FILENO);
+		dup2(slave, STDIN_FILENO);
+		dup2(slave, STDOUT_FILENO);
+
+		std::vector<char> session = make_session_keys();
+		frames = 0;
+		std::thread feeder(feed_keys, master, &session);
+		std::thread drainer(drain_output, master);
+
+		settings.set_seed(CHECK_SEED);
+		frame_log menu_log;
+		frame_log log;
+		{
+			CountingLinux io_linux(&settings);
+			{
+				MainMenu<CountingLinux> main_menu(&io_linux);
+				GameState<CountingLinux> game_state(&io_linux);
+				if(main_menu.menu_loop(&settings) == 0) {
+					game_state.game_loop(&settings);
+				}
+			}
+			session_over = true;
+			feeder.join();
+			menu_log = io_linux.menu_log;
+			log = io_linux.log;
+		} // ends the ncurses session
+
+		dup2(old_input, STDIN_FILENO);
+		dup2(old_output, STDOUT_FILENO);
+		close(old_input);
+		close(old_output);
+		close(slave);
+		drainer.join();
+		close(master);
+		ok = report("IOLinux menu", menu_log) && ok;
+		ok = report("IOLinux", log) && ok;
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/**
+	AutoPlayer.cpp
+		Contains the implementation of the functions declared in
+	'AutoPlayer.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include "AutoPlayer.h"
+
+
+AutoPlayer::AutoPlayer() :
+	hidden(NULL),
+	height(0),
+	width(0),
+	position(0),
+	table(NULL),
+	endgame(NULL) {
+	probability.set_node_limit(PLAYER_NODE_LIMIT);
+}
+
+AutoPlayer::~AutoPlayer() {
+	delete endgame;
+}
+
+void AutoPlayer::set_table(TranspositionTable* table) {
+	this->table = table;
+}
+
+// the search keeps a table of its own, most players never need it
+void AutoPlayer::set_endgame(bool on) {
+	if(on && endgame == NULL) {
+		endgame = new EndgameSolver();
+	} else if(!on) {
+		delete endgame;
+		endgame = NULL;
+	}
+}
+
+// flood fills from (x, y) like the game does, telling the solver;
+// false if (x, y) is a bomb
+bool AutoPlayer::reveal(int x, int y, int& revealed) {
+	if(hidden[x][y] == BOMBT) {
+		return false;
+	}
+	stack.clear();
+	stack.push_back(x * MAT_WIDTH + y);
+
+	while(!stack.empty()) {
+		int t = stack.back();
+		stack.pop_back();
+		int tx = t / MAT_WIDTH;
+		int ty = t % MAT_WIDTH;
+		if(visible[tx][ty] != EMPTYH) {
+			continue;
+		}
+
+		int count = 0;
+		for(int dx = -1; dx <= 1; dx ++) {
+			for(int dy = -1; dy <= 1; dy ++) {
+				count += hidden[tx + dx][ty + dy] == BOMBT;
+			}
+		}
+		visible[tx][ty] = count ? '0' + count : EMPTYD;
+		position ^= zobrist_tile(tx, ty, visible[tx][ty]);
+		solver.update(tx, ty);
+		revealed ++;
+
+		if(count == 0) {
+			for(int dx = -1; dx <= 1; dx ++) {
+				for(int dy = -1; dy <= 1; dy ++) {
+					if(visible[tx + dx][ty + dy] == EMPTYH) {
+						stack.push_back(t + dx * MAT_WIDTH + dy);
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// the safest tile (or the endgame's best move), closest to (x, y) among
+// equals, or the first hidden tile not proven a mine if the probabilities
+// take too long
+// (a position met before is looked up; the answer also depends on (x, y))
+bool AutoPlayer::guess(int bombs, int& x, int& y) {
+	uint64_t key = position ^ zobrist_cursor(x, y);
+	uint32_t tile;
+	bool known = table != NULL && table->probe(key, tile);
+	// a stale answer, of a key that collided, is worked out again
+	if(known && tile != PLAYER_NO_GUESS &&
+		visible[tile / MAT_WIDTH][tile % MAT_WIDTH] == EMPTYH) {
+		x = tile / MAT_WIDTH;
+		y = tile % MAT_WIDTH;
+		return true;
+	}
+
+	if(!(known && tile == PLAYER_NO_GUESS)) {
+		double win, mine;
+		bool found = (endgame != NULL &&
+						endgame->solve(visible, height, width, bombs,
+										x, y, win, mine)) ||
+					(probability.compute(visible, height, width, bombs) &&
+						probability.safest(x, y));
+		if(table != NULL) {
+			table->store(key, found ? x * MAT_WIDTH + y : PLAYER_NO_GUESS);
+		}
+		if(found) {
+			return true;
+		}
+	}
+
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			if(visible[i][j] == EMPTYH && !solver.is_mine(i, j)) {
+				x = i;
+				y = j;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+AutoPlayer::result AutoPlayer::play(const char hidden[][MAT_WIDTH], int height,
+									int width, int bombs, int x, int y,
+									bool guesses) {
+	result res;
+	res.won = false;
+	res.guesses = 0;
+	res.revealed = 0;
+	this->hidden = hidden;
+	this->height = height;
+	this->width = width;
+
+	for(int i = 0; i <= height + 1; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			bool wall = i == 0 || j == 0 || i == height + 1 || j == width + 1;
+			visible[i][j] = wall ? WALL : EMPTYH;
+		}
+	}
+	solver.load(visible, height, width);
+	position = zobrist_board(height, width, bombs);
+	if(!reveal(x, y, res.revealed)) {
+		return res;
+	}
+	finish(bombs, x, y, guesses, res);
+	return res;
+}
+
+AutoPlayer::result AutoPlayer::play_from(const char hidden[][MAT_WIDTH],
+										char visible_field[][MAT_WIDTH],
+										int height, int width, int bombs,
+										int x, int y) {
+	result res;
+	res.won = false;
+	res.guesses = 0;
+	res.revealed = 0;
+	this->hidden = hidden;
+	this->height = height;
+	this->width = width;
+
+	// the flags are the player's opinion, not part of the position
+	for(int i = 0; i <= height + 1; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			char ch = visible_field[i][j];
+			visible[i][j] = ch == FLAGT ? EMPTYH : ch;
+			res.revealed += ch == EMPTYD || (ch >= '1' && ch <= '8');
+		}
+	}
+	solver.load(visible, height, width);
+	position = zobrist_position(visible, height, width, bombs);
+	finish(bombs, x, y, true, res);
+	return res;
+}
+
+// reveals the proven safe tiles, and guesses when there are none
+void AutoPlayer::finish(int bombs, int x, int y, bool guesses, result& res) {
+	int safe = height * width - bombs;
+	size_t done = 0;
+
+	while(res.revealed < safe) {
+		const std::vector<int>& tiles = solver.get_safe_tiles();
+		if(done < tiles.size()) {
+			int t = tiles[done ++];
+			x = t / MAT_WIDTH;
+			y = t % MAT_WIDTH;
+			reveal(x, y, res.revealed);
+			continue;
+		}
+		if(solver.solve() > 0) {
+			continue;
+		}
+
+		if(!guesses || !guess(bombs, x, y)) {
+			return;
+		}
+		res.guesses ++;
+		if(!reveal(x, y, res.revealed)) {
+			return;
+		}
+	}
+	res.won = true;
+}
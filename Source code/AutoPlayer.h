@@ -0,0 +1,84 @@
+/**
+	AutoPlayer.h
+		Plays a whole board headless, knowing where the bombs are only to
+	tell what a reveal shows. It reveals the tiles the deterministic solver
+	proves safe and, when there are none left, either stops or guesses the
+	tile least likely to be a mine, from the exact probabilities. Used to
+	check that boards need no guessing, to measure how hard they are and
+	to play positions of a game on to the end. The guesses can be shared
+	through a transposition table, keyed by the Zobrist key of the
+	position, which the player keeps up to date at every reveal. With the
+	endgame search on, the guesses among few unknown tiles are the moves
+	most likely to win instead.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _AUTOPLAYER_H_
+#define _AUTOPLAYER_H_
+
+#include <vector>
+#include "Solver.h"
+#include "Probability.h"
+#include "EndgameSolver.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include "Utils.h"
+
+// enumeration steps allowed for a guess, a far larger frontier is only
+// seen on huge boards and then the first hidden tile is guessed
+#define PLAYER_NODE_LIMIT	1000000
+// stored for a position whose probabilities were not found in time
+#define PLAYER_NO_GUESS		0xffffffffu
+
+
+class AutoPlayer {
+public:
+	struct result {
+		bool won;
+		// guesses made, the one that lost the game included
+		int guesses;
+		int revealed;
+	};
+
+private:
+	char visible[MAT_HEIGHT][MAT_WIDTH];
+	const char (*hidden)[MAT_WIDTH];
+	int height;
+	int width;
+	// Zobrist key of visible
+	uint64_t position;
+	std::vector<int> stack;
+	Solver solver;
+	ProbabilityEngine probability;
+	// guesses already made, NULL if they are not kept
+	TranspositionTable* table;
+	// NULL unless the endgame search is on
+	EndgameSolver* endgame;
+
+	bool reveal(int x, int y, int& revealed);
+	bool guess(int bombs, int& x, int& y);
+	void finish(int bombs, int x, int y, bool guesses, result& res);
+
+public:
+	AutoPlayer();
+	~AutoPlayer();
+
+	// keeps the guesses in table, which may be shared by many players
+	// of the same positions (e.g. on several threads)
+	void set_table(TranspositionTable* table);
+	// guesses the moves most likely to win once few tiles are unknown
+	// (off by default)
+	void set_endgame(bool on);
+
+	// plays the height x width board in hidden (BOMBT for the bombs) from
+	// the first reveal (x, y); without guesses it stops once stuck
+	result play(const char hidden[][MAT_WIDTH], int height, int width,
+				int bombs, int x, int y, bool guesses);
+	// plays the same board on from the position in visible_field, with
+	// guesses, the first one closest to (x, y) among equals
+	result play_from(const char hidden[][MAT_WIDTH],
+						char visible_field[][MAT_WIDTH], int height, int width,
+						int bombs, int x, int y);
+};
+
+#endif // _AUTOPLAYER_H_
@@ -0,0 +1,220 @@
+/**
+	BoardGenerator.cpp
+		Contains the implementation of the functions declared in
+	'BoardGenerator.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "BoardGenerator.h"
+
+
+BoardGenerator::BoardGenerator(int threads) :
+	nr_of_threads(0),
+	height(0),
+	width(0),
+	bombs(0),
+	first_x(1),
+	first_y(1),
+	seed(0),
+	no_guess(false),
+	min_3bv(0),
+	max_3bv(0),
+	time_limit_ms(GENERATOR_BUDGET_MS),
+	best(0),
+	next(0),
+	attempts(0) {
+	set_threads(threads);
+}
+
+BoardGenerator::~BoardGenerator() {
+	for(size_t i = 0; i < candidates.size(); i ++) {
+		delete candidates[i];
+	}
+}
+
+void BoardGenerator::set_threads(int threads) {
+	nr_of_threads = threads;
+	if(nr_of_threads <= 0) {
+		nr_of_threads = std::thread::hardware_concurrency();
+	}
+	if(nr_of_threads <= 0) {
+		nr_of_threads = 1;
+	}
+}
+
+void BoardGenerator::set_3bv_range(int min, int max) {
+	min_3bv = min;
+	max_3bv = max;
+}
+
+void BoardGenerator::set_time_limit(int ms) {
+	time_limit_ms = ms;
+}
+
+uint64_t BoardGenerator::get_attempts() {
+	return attempts;
+}
+
+bool BoardGenerator::generate(char field[][MAT_WIDTH], int height, int width,
+								int bombs, int x, int y, uint64_t seed,
+								bool no_guess) {
+	this->height = height;
+	this->width = width;
+	this->bombs = bombs;
+	first_x = x;
+	first_y = y;
+	this->seed = seed;
+	this->no_guess = no_guess;
+
+	// the candidates are kept from a board to the next, they are large
+	bool search = no_guess || min_3bv > 0 || max_3bv > 0;
+	int threads = search ? nr_of_threads : 1;
+	while((int)candidates.size() < threads) {
+		candidates.push_back(new candidate());
+	}
+	prepare();
+
+	best = UINT64_MAX;
+	next = 0;
+	attempts = 0;
+	deadline = std::chrono::steady_clock::now() +
+				std::chrono::milliseconds(time_limit_ms);
+	if(!search) {
+		place(*candidates[0], 0);
+		attempts = 1;
+		best = 0;
+		keep(*candidates[0]);
+	} else {
+		std::vector<std::thread> helpers;
+		for(int t = 1; t < threads; t ++) {
+			helpers.push_back(std::thread(&BoardGenerator::work, this, t));
+		}
+		work(0);
+		for(size_t t = 0; t < helpers.size(); t ++) {
+			helpers[t].join();
+		}
+	}
+
+	bool found = best != UINT64_MAX;
+	if(!found) {
+		place(*candidates[0], 0);
+		keep(*candidates[0]);
+	}
+	for(int i = 0; i <= height + 1; i ++) {
+		memcpy(field[i], result[i], width + 2);
+	}
+	return found;
+}
+
+void BoardGenerator::sample_3bv(int height, int width, int bombs,
+								uint64_t seed, int& low, int& high) {
+	this->height = height;
+	this->width = width;
+	this->bombs = bombs;
+	first_x = (height + 1) / 2;
+	first_y = (width + 1) / 2;
+	this->seed = seed;
+	if(candidates.empty()) {
+		candidates.push_back(new candidate());
+	}
+	prepare();
+
+	candidate& c = *candidates[0];
+	low = height * width;
+	high = 0;
+	for(uint64_t k = 0; k < SAMPLE_3BV_BOARDS; k ++) {
+		place(c, k);
+		int bbbv = c.rater.rate(c.hidden, height, width).bbbv;
+		low = std::min(low, bbbv);
+		high = std::max(high, bbbv);
+	}
+}
+
+// copies the board of c and its borders to the result, only its rows
+// are worth it
+void BoardGenerator::keep(candidate& c) {
+	for(int i = 0; i <= height + 1; i ++) {
+		memcpy(result[i], c.hidden[i], width + 2);
+	}
+}
+
+// lists the tiles bombs may go to: all but the 3x3 block around the
+// first tile, or all but the first tile if the block does not fit
+void BoardGenerator::prepare() {
+	bool block = height * width - 9 >= bombs;
+
+	free_cells.clear();
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			bool near = std::abs(i - first_x) <= 1 && std::abs(j - first_y) <= 1;
+			if(block ? !near : (i != first_x || j != first_y)) {
+				free_cells.push_back(i * MAT_WIDTH + j);
+			}
+		}
+	}
+}
+
+// the first bombs tiles of a partial Fisher-Yates shuffle get the bombs;
+// every attempt starts from the same order, so it only depends on its seed
+void BoardGenerator::place(candidate& c, uint64_t attempt) {
+	uint64_t state = splitmix64(seed + attempt * 0x9E3779B97F4A7C15ULL);
+	size_t n = free_cells.size();
+
+	c.cells.assign(free_cells.begin(), free_cells.end());
+	for(int i = 0; i <= height + 1; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			bool wall = i == 0 || j == 0 || i == height + 1 || j == width + 1;
+			c.hidden[i][j] = wall ? WALL : EMPTYH;
+		}
+	}
+	for(int k = 0; k < bombs && k < (int)n; k ++) {
+		size_t pick = k + splitmix64(state + k) % (n - k);
+		std::swap(c.cells[k], c.cells[pick]);
+		c.hidden[c.cells[k] / MAT_WIDTH][c.cells[k] % MAT_WIDTH] = BOMBT;
+	}
+}
+
+// rating is much cheaper than solving, so it is done first
+bool BoardGenerator::accepted(candidate& c) {
+	if(min_3bv > 0 || max_3bv > 0) {
+		int bbbv = c.rater.rate(c.hidden, height, width).bbbv;
+		if(bbbv < min_3bv || (max_3bv > 0 && bbbv > max_3bv)) {
+			return false;
+		}
+	}
+	return !no_guess ||
+			c.player.play(c.hidden, height, width, bombs, first_x, first_y,
+							false).won;
+}
+
+// tries attempts until one with a lower index than the next is accepted;
+// the attempts below an accepted one were all started before it, and are
+// finished even past the deadline, so the board found does not depend on
+// the timing
+void BoardGenerator::work(int worker) {
+	candidate& c = *candidates[worker];
+
+	while(true) {
+		if(time_limit_ms > 0 && std::chrono::steady_clock::now() > deadline) {
+			return;
+		}
+		uint64_t attempt = next ++;
+		if(attempt >= best || attempt >= MAX_GENERATOR_ATTEMPTS) {
+			return;
+		}
+
+		place(c, attempt);
+		attempts ++;
+		if(accepted(c)) {
+			std::lock_guard<std::mutex> guard(lock);
+			if(attempt < best) {
+				best = attempt;
+				keep(c);
+			}
+		}
+	}
+}
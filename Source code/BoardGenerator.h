@@ -0,0 +1,104 @@
+/**
+	BoardGenerator.h
+		Places the bombs of a board once the first tile to reveal is
+	known, keeping them out of the 3x3 block around it when the board
+	leaves room for that. For no-guess boards, candidates are made and
+	played by the deterministic solver from the first tile on all cores at
+	once, and only boards it clears are accepted. Attempt k is always built
+	from the same seed and the accepted board is the one with the lowest k,
+	so a seed gives the same board whatever the number of threads.
+	Boards can also be asked for within a 3BV range, in which case the
+	attempts are rated first and the ones out of range are rejected.
+	The search stops after a number of attempts or a time limit, as the
+	first reveal waits for it, and a random board is kept instead.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _BOARDGENERATOR_H_
+#define _BOARDGENERATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include "AutoPlayer.h"
+#include "BoardRater.h"
+#include "Utils.h"
+
+// attempts before giving up and keeping a board that is not accepted,
+// and the time they may take
+#define MAX_GENERATOR_ATTEMPTS	1000000
+#define GENERATOR_BUDGET_MS		2000
+// random boards rated to tell the 3BV a board size can be asked for
+#define SAMPLE_3BV_BOARDS		200
+
+
+class BoardGenerator {
+private:
+	// a board being tried by one thread
+	struct candidate {
+		char hidden[MAT_HEIGHT][MAT_WIDTH];
+		// the tiles bombs may go to, in the order an attempt shuffled them
+		std::vector<int> cells;
+		AutoPlayer player;
+		BoardRater rater;
+	};
+
+	int nr_of_threads;
+	std::vector<candidate*> candidates;
+	// the tiles bombs may go to
+	std::vector<int> free_cells;
+	// the board being made
+	int height;
+	int width;
+	int bombs;
+	int first_x;
+	int first_y;
+	uint64_t seed;
+	bool no_guess;
+	// accepted 3BV, 0 for no limit
+	int min_3bv;
+	int max_3bv;
+	// when to stop searching, 0 ms for never
+	int time_limit_ms;
+	std::chrono::steady_clock::time_point deadline;
+	// lowest accepted attempt, the next attempt to start and attempts made
+	std::atomic<uint64_t> best;
+	std::atomic<uint64_t> next;
+	std::atomic<uint64_t> attempts;
+	std::mutex lock;
+	char result[MAT_HEIGHT][MAT_WIDTH];
+
+	void prepare();
+	void place(candidate& c, uint64_t attempt);
+	bool accepted(candidate& c);
+	void keep(candidate& c);
+	void work(int worker);
+
+public:
+	// 0 threads means one for every core
+	BoardGenerator(int threads);
+	~BoardGenerator();
+
+	// writes BOMBT or EMPTYH to every tile of the height x width board in
+	// field, and WALL to its borders; the first tile revealed will be (x, y). Returns false if no
+	// board was found that is no-guess and within the 3BV range, in which
+	// case the board is a random one
+	bool generate(char field[][MAT_WIDTH], int height, int width, int bombs,
+					int x, int y, uint64_t seed, bool no_guess);
+	// attempts made by the last generate call
+	uint64_t get_attempts();
+	void set_threads(int threads);
+	// only boards with a 3BV between min and max are generated,
+	// 0 for no limit
+	void set_3bv_range(int min, int max);
+	// the search for a board gives up after ms milliseconds, 0 for no limit
+	void set_time_limit(int ms);
+	// the lowest and highest 3BV of random boards of this size, first
+	// revealed in the middle: the range boards can be asked for in time
+	void sample_3bv(int height, int width, int bombs, uint64_t seed,
+					int& low, int& high);
+};
+
+#endif // _BOARDGENERATOR_H_
@@ -0,0 +1,118 @@
+/**
+	BoardRater.cpp
+		Contains the implementation of the functions declared in
+	'BoardRater.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include "BoardRater.h"
+
+// never the number of a safe tile
+#define NOT_SAFE	9
+
+
+BoardRater::BoardRater() :
+	count(MAT_HEIGHT * MAT_WIDTH, NOT_SAFE),
+	parent(MAT_HEIGHT * MAT_WIDTH, 0),
+	column(MAT_WIDTH, 0),
+	empty(MAT_HEIGHT * MAT_WIDTH, 0)
+	{}
+
+// path halving keeps the trees flat enough without ranks
+int BoardRater::find(int t) {
+	while(parent[t] != t) {
+		parent[t] = parent[parent[t]];
+		t = parent[t];
+	}
+	return t;
+}
+
+// joins the openings of a and b, one less if they were apart
+void BoardRater::join(int a, int b, int& openings) {
+	a = find(a);
+	b = find(b);
+	if(a != b) {
+		parent[a] = b;
+		openings --;
+	}
+}
+
+board_rating BoardRater::rate(const char field[][MAT_WIDTH], int height, int width) {
+	board_rating rating;
+	rating.openings = 0;
+	rating.isolated = 0;
+
+	// the borders may hold the counts of a larger board rated before
+	for(int j = 0; j <= width + 1; j ++) {
+		count[j] = NOT_SAFE;
+		count[(height + 1) * MAT_WIDTH + j] = NOT_SAFE;
+	}
+	for(int i = 1; i <= height; i ++) {
+		count[i * MAT_WIDTH] = NOT_SAFE;
+		count[i * MAT_WIDTH + width + 1] = NOT_SAFE;
+	}
+
+	int nr_of_empty = 0;
+
+	// the bombs around a tile are summed from the bombs in the columns
+	// of the three rows around it
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			column[j] = (field[i - 1][j] == BOMBT) + (field[i][j] == BOMBT)
+						+ (field[i + 1][j] == BOMBT);
+		}
+		for(int j = 1; j <= width; j ++) {
+			int t = i * MAT_WIDTH + j;
+			int bombs = column[j - 1] + column[j] + column[j + 1];
+			count[t] = field[i][j] == BOMBT ? NOT_SAFE : bombs;
+			// listed without a branch, which a random board would
+			// mispredict about every other tile
+			empty[nr_of_empty] = t;
+			nr_of_empty += count[t] == 0;
+		}
+	}
+
+	// every empty tile is joined to the empty ones before it (left, up
+	// left, up, up right); the ones up left and up right already are in
+	// the same opening as the one up when that one is empty
+	for(int k = 0; k < nr_of_empty; k ++) {
+		int t = empty[k];
+		if(count[t - 1] == 0) {
+			parent[t] = find(t - 1);
+		} else {
+			parent[t] = t;
+			rating.openings ++;
+		}
+		int up = t - MAT_WIDTH;
+		if(count[up] == 0) {
+			join(t, up, rating.openings);
+		} else {
+			if(count[up - 1] == 0) {
+				join(t, up - 1, rating.openings);
+			}
+			if(count[up + 1] == 0) {
+				join(t, up + 1, rating.openings);
+			}
+		}
+	}
+
+	// numbers are opened with an empty neighbour, or clicked on their
+	// own; the empty neighbours are summed by columns too
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			int t = i * MAT_WIDTH + j;
+			column[j] = (count[t - MAT_WIDTH] == 0) + (count[t] == 0)
+						+ (count[t + MAT_WIDTH] == 0);
+		}
+		for(int j = 1; j <= width; j ++) {
+			int t = i * MAT_WIDTH + j;
+			// 1 to 8, without branches either
+			int number = (unsigned)count[t] - 1 < NOT_SAFE - 1;
+			int near_empty = column[j - 1] + column[j] + column[j + 1];
+			rating.isolated += number & (near_empty == 0);
+		}
+	}
+
+	rating.bbbv = rating.openings + rating.isolated;
+	return rating;
+}
@@ -0,0 +1,48 @@
+/**
+	BoardRater.h
+		Rates how much work a board is: its 3BV (the fewest clicks that
+	clear it without flags), made of the openings (areas of empty tiles,
+	opened by one click together with the numbers around them) and of the
+	isolated numbers, that touch no empty tile and need a click of their
+	own. The numbers are summed by columns, the openings are counted with
+	a union-find over the empty tiles and the isolated numbers in a last
+	pass, so a board is rated in time linear in its size.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _BOARDRATER_H_
+#define _BOARDRATER_H_
+
+#include <vector>
+#include "Utils.h"
+
+struct board_rating {
+	int bbbv;
+	int openings;
+	int isolated;
+};
+
+
+class BoardRater {
+private:
+	// bombs around every tile, 9 for bombs and the borders
+	std::vector<char> count;
+	// union-find over the empty tiles
+	std::vector<int> parent;
+	// per column sums of the row being counted
+	std::vector<int> column;
+	// the empty tiles, in reading order
+	std::vector<int> empty;
+
+	int find(int t);
+	void join(int a, int b, int& openings);
+
+public:
+	BoardRater();
+
+	// rates the height x width board in field, where bombs are BOMBT
+	// (e.g. the hidden field of a game)
+	board_rating rate(const char field[][MAT_WIDTH], int height, int width);
+};
+
+#endif // _BOARDRATER_H_
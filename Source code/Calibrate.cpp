@@ -0,0 +1,327 @@
+/**
+	Calibrate.cpp
+		Measures how hard boards are over a grid of heights, widths and
+	bomb densities, so the difficulty presets can be picked from data.
+	Every point of the grid is played many times by the solver (the tiles
+	it proves safe, then the safest guess) on all cores, and its win rate,
+	guesses and time per game are reported with 95% confidence intervals.
+	The presets closest to the target win rates are printed, and written
+	to a presets file that the game reads instead of its own presets.
+
+	Usage: './minesweeper-calibrate [-n GAMES] [-t THREADS] [-s SEED]
+	[-H HEIGHTS] [-W WIDTHS] [-D DENSITIES] [-w TARGETS] [-o FILE]'
+
+	@author Sergiu Constantinescu
+*/
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "AutoPlayer.h"
+#include "BoardGenerator.h"
+#include "GameSettings.h"
+#include "WorkStealingPool.h"
+#include "Utils.h"
+
+
+// statistics gathered by every thread for one point, merged at the end
+struct point_stats {
+	uint64_t games;
+	uint64_t wins;
+	double guesses;
+	double guesses_sq;
+	double seconds;
+	double seconds_sq;
+
+	point_stats() : games(0), wins(0), guesses(0.0), guesses_sq(0.0),
+					seconds(0.0), seconds_sq(0.0) {}
+
+	void merge(const point_stats& other) {
+		games += other.games;
+		wins += other.wins;
+		guesses += other.guesses;
+		guesses_sq += other.guesses_sq;
+		seconds += other.seconds;
+		seconds_sq += other.seconds_sq;
+	}
+};
+
+// a point of the grid and what was measured there
+struct grid_point {
+	int height;
+	int width;
+	int bombs;
+	double win_rate;
+	// 95% Wilson interval of the win rate
+	double win_low;
+	double win_high;
+	double guesses;
+	double guesses_error;
+	double ms;
+	double ms_error;
+};
+
+// the objects owned by one thread
+struct calibrate_worker {
+	BoardGenerator generator;
+	AutoPlayer player;
+	char field[MAT_HEIGHT][MAT_WIDTH];
+
+	calibrate_worker() : generator(1) {}
+};
+
+// plays the games of one point, from random first tiles
+void measure(grid_point& point, uint64_t nr_of_games, uint64_t base_seed,
+				WorkStealingPool& pool, std::vector<calibrate_worker*>& workers) {
+	std::vector<per_thread<point_stats> > stats(pool.get_threads());
+
+	pool.parallel_for(nr_of_games, 16, [&](int w, size_t game) {
+		calibrate_worker& worker = *workers[w];
+		uint64_t seed = splitmix64(base_seed + game);
+		int x = 1 + seed % point.height;
+		int y = 1 + (seed >> 32) % point.width;
+		worker.generator.generate(worker.field, point.height, point.width,
+									point.bombs, x, y, seed, false);
+
+		auto start = std::chrono::steady_clock::now();
+		AutoPlayer::result res = worker.player.play(worker.field, point.height,
+											point.width, point.bombs, x, y, true);
+		double seconds = std::chrono::duration<double>(
+							std::chrono::steady_clock::now() - start).count();
+
+		point_stats& s = stats[w].value;
+		s.games ++;
+		s.wins += res.won;
+		s.guesses += res.guesses;
+		s.guesses_sq += (double)res.guesses * res.guesses;
+		s.seconds += seconds;
+		s.seconds_sq += seconds * seconds;
+	});
+
+	point_stats total;
+	for(size_t w = 0; w < stats.size(); w ++) {
+		total.merge(stats[w].value);
+	}
+	point.win_rate = (double)total.wins / total.games;
+	wilson_interval(total.wins, total.games, point.win_low, point.win_high);
+	point.guesses = total.guesses / total.games;
+	point.guesses_error = mean_error(total.guesses, total.guesses_sq, total.games);
+	point.ms = 1000.0 * total.seconds / total.games;
+	point.ms_error = 1000.0 * mean_error(total.seconds, total.seconds_sq,
+											total.games);
+}
+
+// comma separated numbers; false if one is not a number or there is none
+bool parse_list(const char* text, std::vector<double>& values) {
+	std::istringstream list(text);
+	std::string item;
+	values.clear();
+	while(std::getline(list, item, ',')) {
+		char* end;
+		double value = strtod(item.c_str(), &end);
+		if(item.empty() || *end != '\0' || !std::isfinite(value)) {
+			return false;
+		}
+		values.push_back(value);
+	}
+	return !values.empty();
+}
+
+// every preset keeps its board size if the grid has it, and gets the
+// density whose win rate is the closest to its target; false if a preset
+// has no point to pick
+bool pick_presets(const std::vector<grid_point>& points,
+					const std::vector<double>& targets, int picked[5]) {
+	GameSettings settings;
+
+	for(int preset = 1; preset <= 4; preset ++) {
+		settings.set_diff(preset);
+		bool same_size = false;
+		for(size_t k = 0; k < points.size(); k ++) {
+			same_size = same_size ||
+						(points[k].height == settings.get_height() &&
+						points[k].width == settings.get_width());
+		}
+
+		picked[preset] = -1;
+		double target = targets[preset - 1] / 100.0;
+		for(size_t k = 0; k < points.size(); k ++) {
+			if(same_size && (points[k].height != settings.get_height() ||
+								points[k].width != settings.get_width())) {
+				continue;
+			}
+			if(picked[preset] < 0 ||
+				std::fabs(points[k].win_rate - target) <
+				std::fabs(points[picked[preset]].win_rate - target)) {
+				picked[preset] = k;
+			}
+		}
+		if(picked[preset] < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool write_presets(const char* path, const std::vector<grid_point>& points,
+					const int picked[5], uint64_t nr_of_games) {
+	std::ofstream file(path);
+	if(!file) {
+		return false;
+	}
+
+	char line[128];
+	file << "# difficulty presets, made by minesweeper-calibrate from "
+			<< nr_of_games << " games per point" << std::endl;
+	file << "# preset height width bombs" << std::endl;
+	for(int preset = 1; preset <= 4; preset ++) {
+		const grid_point& p = points[picked[preset]];
+		snprintf(line, sizeof(line), "%d %d %d %d\t# %.1f%% won",
+					preset, p.height, p.width, p.bombs, 100.0 * p.win_rate);
+		file << line << std::endl;
+	}
+	return true;
+}
+
+void usage() {
+	std::cout << "Usage: './minesweeper-calibrate [-n GAMES] [-t THREADS]"
+				<< " [-s SEED] [-H HEIGHTS] [-W WIDTHS]" << std::endl;
+	std::cout << "\t[-D DENSITIES] [-w TARGETS] [-o FILE]'" << std::endl;
+	std::cout << "\tGAMES     - games per point of the grid (default 10000)"
+				<< std::endl;
+	std::cout << "\tTHREADS   - threads to use (default one per core)"
+				<< std::endl;
+	std::cout << "\tSEED      - base seed of the boards (default 1)"
+				<< std::endl;
+	std::cout << "\tHEIGHTS   - board heights, e.g. 9,14 (the default)"
+				<< std::endl;
+	std::cout << "\tWIDTHS    - board widths (default 9,19,34,68)"
+				<< std::endl;
+	std::cout << "\tDENSITIES - % of bombs (default 10,12.5,15,17.5,20,22.5)"
+				<< std::endl;
+	std::cout << "\tTARGETS   - % of games won for the presets 1 to 4"
+				<< " (default 90,75,45,30)" << std::endl;
+	std::cout << "\tFILE      - presets file to write, e.g. '"
+				<< PRESETS_FILE << "'" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	uint64_t nr_of_games = 10000;
+	int nr_of_threads = 0;
+	uint64_t base_seed = 1;
+	std::vector<double> heights;
+	std::vector<double> widths;
+	std::vector<double> densities;
+	std::vector<double> targets;
+	const char* output = NULL;
+	bool parsed = parse_list("9,14", heights) &&
+					parse_list("9,19,34,68", widths) &&
+					parse_list("10,12.5,15,17.5,20,22.5", densities) &&
+					parse_list("90,75,45,30", targets);
+
+	for(int i = 1; i < argc; i ++) {
+		std::string arg(argv[i]);
+		if(i + 1 >= argc) {
+			usage();
+			return 1;
+		}
+		if(arg == "-n") {
+			nr_of_games = strtoull(argv[++ i], NULL, 10);
+		} else if(arg == "-t") {
+			nr_of_threads = atoi(argv[++ i]);
+		} else if(arg == "-s") {
+			base_seed = strtoull(argv[++ i], NULL, 10);
+		} else if(arg == "-H") {
+			parsed = parse_list(argv[++ i], heights) && parsed;
+		} else if(arg == "-W") {
+			parsed = parse_list(argv[++ i], widths) && parsed;
+		} else if(arg == "-D") {
+			parsed = parse_list(argv[++ i], densities) && parsed;
+		} else if(arg == "-w") {
+			parsed = parse_list(argv[++ i], targets) && parsed;
+		} else if(arg == "-o") {
+			output = argv[++ i];
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if(!parsed || nr_of_games == 0 || targets.size() != 4) {
+		usage();
+		return 1;
+	}
+
+	// the same limits as the custom boards
+	GameSettings limits;
+	std::vector<grid_point> points;
+	for(size_t h = 0; h < heights.size(); h ++) {
+		for(size_t w = 0; w < widths.size(); w ++) {
+			for(size_t d = 0; d < densities.size(); d ++) {
+				limits.set_custom_diff((int)heights[h], (int)widths[w],
+					(int)std::lround(heights[h] * widths[w] * densities[d] / 100));
+				grid_point point;
+				point.height = limits.get_height();
+				point.width = limits.get_width();
+				point.bombs = limits.get_bombs();
+				points.push_back(point);
+			}
+		}
+	}
+
+	WorkStealingPool pool(nr_of_threads);
+	std::vector<calibrate_worker*> workers;
+	for(int w = 0; w < pool.get_threads(); w ++) {
+		workers.push_back(new calibrate_worker());
+	}
+
+	char line[160];
+	std::cout << points.size() << " points, " << nr_of_games
+				<< " games each (" << pool.get_threads() << " threads),"
+				<< " 95% intervals" << std::endl;
+	std::cout << "  Size   Bombs  Density     Won %       (interval)"
+				<< "     Guesses        ms/game" << std::endl;
+	for(size_t k = 0; k < points.size(); k ++) {
+		grid_point& p = points[k];
+		measure(p, nr_of_games, base_seed, pool, workers);
+		snprintf(line, sizeof(line),
+					"%3dx%-3d %6d %7.2f%% %8.2f%%  (%6.2f - %6.2f)"
+					" %6.2f +- %-5.2f %7.3f +- %.3f",
+					p.height, p.width, p.bombs,
+					100.0 * p.bombs / (p.height * p.width),
+					100.0 * p.win_rate, 100.0 * p.win_low, 100.0 * p.win_high,
+					p.guesses, p.guesses_error, p.ms, p.ms_error);
+		std::cout << line << std::endl;
+	}
+	for(size_t w = 0; w < workers.size(); w ++) {
+		delete workers[w];
+	}
+
+	int picked[5];
+	if(!pick_presets(points, targets, picked)) {
+		std::cout << "No point of the grid for every preset." << std::endl;
+		return 1;
+	}
+	std::cout << std::endl << "Presets (target win rate)" << std::endl;
+	for(int preset = 1; preset <= 4; preset ++) {
+		const grid_point& p = points[picked[preset]];
+		snprintf(line, sizeof(line), "%d %d %d %d\t# %.1f%% won (%.0f%%)",
+					preset, p.height, p.width, p.bombs, 100.0 * p.win_rate,
+					targets[preset - 1]);
+		std::cout << line << std::endl;
+	}
+
+	if(output != NULL) {
+		if(!write_presets(output, points, picked, nr_of_games)) {
+			std::cout << "Could not write the presets." << std::endl;
+			return 1;
+		}
+		std::cout << "Written to '" << output << "'." << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,363 @@
+/**
+	EndgameSolver.cpp
+		Contains the implementation of the functions declared in
+	'EndgameSolver.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "EndgameSolver.h"
+#include "Zobrist.h"
+
+
+// a layout that survives a move, the position it leads to and its key
+struct outcome {
+	uint64_t key;
+	uint32_t revealed;
+	uint32_t layout;
+
+	bool operator<(const outcome& other) const {
+		return key < other.key;
+	}
+};
+
+// a move to try, and how to order them
+struct candidate {
+	int t;
+	int mines;
+	int distance;
+
+	bool operator<(const candidate& other) const {
+		if(mines != other.mines) {
+			return mines < other.mines;
+		}
+		if(distance != other.distance) {
+			return distance < other.distance;
+		}
+		return t < other.t;
+	}
+};
+
+
+EndgameSolver::EndgameSolver() :
+	height(0),
+	width(0),
+	nr_of_tiles(0),
+	nodes(0),
+	node_limit(ENDGAME_NODE_LIMIT),
+	cancel(NULL),
+	time_limit_ms(0),
+	aborted(false),
+	table(ENDGAME_TABLE_BITS),
+	origin_x(1),
+	origin_y(1)
+	{}
+
+void EndgameSolver::set_node_limit(long limit) {
+	node_limit = limit;
+}
+
+void EndgameSolver::set_cancel(const std::atomic<bool>* flag) {
+	cancel = flag;
+}
+
+void EndgameSolver::set_time_limit(int ms) {
+	time_limit_ms = ms;
+}
+
+bool EndgameSolver::collect(char visible_field[][MAT_WIDTH], int bombs) {
+	// every unknown tile is at least one of the bombs not yet placed, so
+	// most positions are turned down before the solver is run
+	int hidden = 0;
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			hidden += visible_field[i][j] == EMPTYH ||
+						visible_field[i][j] == FLAGT;
+		}
+	}
+	if(hidden == 0 || hidden - bombs > ENDGAME_MAX_TILES) {
+		return false;
+	}
+
+	solver.load(visible_field, height, width);
+	solver.solve();
+
+	int mines = bombs;
+	nr_of_tiles = 0;
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			char ch = visible_field[i][j];
+			if(ch != EMPTYH && ch != FLAGT) {
+				continue;
+			}
+			if(solver.is_mine(i, j)) {
+				mines --;
+			} else if(nr_of_tiles == ENDGAME_MAX_TILES) {
+				return false;
+			} else {
+				tiles[nr_of_tiles ++] = i * MAT_WIDTH + j;
+			}
+		}
+	}
+	if(nr_of_tiles == 0 || mines < 0 || mines > nr_of_tiles) {
+		return false;
+	}
+
+	for(int t = 0; t < nr_of_tiles; t ++) {
+		neighbours[t] = 0;
+		fixed_mines[t] = 0;
+		for(int dx = -1; dx <= 1; dx ++) {
+			for(int dy = -1; dy <= 1; dy ++) {
+				int n = tiles[t] + dx * MAT_WIDTH + dy;
+				int* found = std::find(tiles, tiles + nr_of_tiles, n);
+				if(n == tiles[t]) {
+					continue;
+				}
+				if(found != tiles + nr_of_tiles) {
+					neighbours[t] |= 1u << (found - tiles);
+				} else if(solver.is_mine(n / MAT_WIDTH, n % MAT_WIDTH)) {
+					fixed_mines[t] ++;
+				}
+			}
+		}
+	}
+
+	// the numbers next to unknown tiles, as masks and the mines they miss
+	std::vector<uint32_t> masks;
+	std::vector<int> needed;
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			char ch = visible_field[i][j];
+			if(ch < '1' || ch > '8') {
+				continue;
+			}
+			uint32_t mask = 0;
+			int need = ch - '0';
+			for(int dx = -1; dx <= 1; dx ++) {
+				for(int dy = -1; dy <= 1; dy ++) {
+					int n = (i + dx) * MAT_WIDTH + j + dy;
+					int* found = std::find(tiles, tiles + nr_of_tiles, n);
+					if(found != tiles + nr_of_tiles) {
+						mask |= 1u << (found - tiles);
+					} else if(solver.is_mine(i + dx, j + dy)) {
+						need --;
+					}
+				}
+			}
+			if(mask != 0) {
+				masks.push_back(mask);
+				needed.push_back(need);
+			}
+		}
+	}
+
+	// the sets of exactly mines bits, in increasing order (Gosper's hack)
+	layouts.clear();
+	uint32_t end = 1u << nr_of_tiles;
+	uint32_t l = (1u << mines) - 1;
+	while(l < end) {
+		bool ok = true;
+		for(size_t c = 0; ok && c < masks.size(); c ++) {
+			ok = __builtin_popcount(l & masks[c]) == needed[c];
+		}
+		if(ok) {
+			layouts.push_back(l);
+		}
+		if(l == 0) {
+			break;
+		}
+		uint32_t low = l & -l;
+		uint32_t ripple = l + low;
+		l = ripple | (((l ^ ripple) >> 2) / low);
+	}
+	return !layouts.empty();
+}
+
+bool EndgameSolver::out_of_budget() {
+	if(++ nodes > node_limit) {
+		return true;
+	}
+	// the clock and the flag are only looked at now and then
+	if(nodes % 256 == 0) {
+		if(cancel != NULL && *cancel) {
+			return true;
+		}
+		if(time_limit_ms > 0 && std::chrono::steady_clock::now() > deadline) {
+			return true;
+		}
+	}
+	return false;
+}
+
+double EndgameSolver::search(uint32_t revealed, uint64_t key,
+								const std::vector<uint32_t>& layouts,
+								int* move) {
+	if(out_of_budget()) {
+		aborted = true;
+		return 0.0;
+	}
+	// a single layout is known, its safe tiles are revealed one by one
+	if(move == NULL && layouts.size() == 1) {
+		return 1.0;
+	}
+	uint32_t stored;
+	float value;
+	if(move == NULL && table.probe(key, stored)) {
+		memcpy(&value, &stored, sizeof(value));
+		return value;
+	}
+
+	int mines[ENDGAME_MAX_TILES] = {0};
+	for(size_t k = 0; k < layouts.size(); k ++) {
+		uint32_t l = layouts[k] & ~revealed;
+		while(l != 0) {
+			mines[__builtin_ctz(l)] ++;
+			l &= l - 1;
+		}
+	}
+
+	std::vector<candidate> moves;
+	for(int t = 0; t < nr_of_tiles; t ++) {
+		if(revealed & (1u << t) || mines[t] == (int)layouts.size()) {
+			continue;
+		}
+		candidate c;
+		c.t = t;
+		c.mines = mines[t];
+		c.distance = std::max(std::abs(tiles[t] / MAT_WIDTH - origin_x),
+								std::abs(tiles[t] % MAT_WIDTH - origin_y));
+		moves.push_back(c);
+	}
+	std::sort(moves.begin(), moves.end());
+
+	// revealing a safe tile never hurts, the other moves are not needed
+	if(!moves.empty() && moves[0].mines == 0) {
+		moves.resize(1);
+	}
+
+	double best = -1.0;
+	int best_move = -1;
+	for(size_t m = 0; m < moves.size(); m ++) {
+		double survive = 1.0 - (double)moves[m].mines / layouts.size();
+		if(survive <= best) {
+			break;
+		}
+		double v = play(revealed, key, layouts, moves[m].t);
+		if(aborted) {
+			return 0.0;
+		}
+		if(v > best) {
+			best = v;
+			best_move = moves[m].t;
+		}
+	}
+
+	if(move != NULL) {
+		*move = best_move;
+	}
+	value = best;
+	memcpy(&stored, &value, sizeof(stored));
+	table.store(key, stored);
+	return best;
+}
+
+double EndgameSolver::play(uint32_t revealed, uint64_t key,
+							const std::vector<uint32_t>& layouts, int t) {
+	std::vector<outcome> outcomes;
+	int stack[ENDGAME_MAX_TILES * 8 + 1];
+
+	for(size_t k = 0; k < layouts.size(); k ++) {
+		uint32_t l = layouts[k];
+		if(l & (1u << t)) {
+			continue;
+		}
+
+		// the flood fill of the game, on this layout
+		outcome o;
+		o.key = key;
+		o.revealed = revealed;
+		o.layout = l;
+		int top = 0;
+		stack[top ++] = t;
+		while(top > 0) {
+			int u = stack[-- top];
+			if(o.revealed & (1u << u)) {
+				continue;
+			}
+			o.revealed |= 1u << u;
+			int n = __builtin_popcount(l & neighbours[u]) + fixed_mines[u];
+			o.key ^= zobrist_tile(tiles[u] / MAT_WIDTH, tiles[u] % MAT_WIDTH,
+									n ? '0' + n : EMPTYD);
+			if(n == 0) {
+				uint32_t next = neighbours[u] & ~o.revealed;
+				while(next != 0) {
+					stack[top ++] = __builtin_ctz(next);
+					next &= next - 1;
+				}
+			}
+		}
+		outcomes.push_back(o);
+	}
+
+	// the layouts showing the same numbers lead to the same position
+	std::sort(outcomes.begin(), outcomes.end());
+	double wins = 0.0;
+	std::vector<uint32_t> part;
+	for(size_t k = 0; k < outcomes.size(); ) {
+		part.clear();
+		size_t first = k;
+		while(k < outcomes.size() && outcomes[k].key == outcomes[first].key) {
+			part.push_back(outcomes[k ++].layout);
+		}
+		wins += part.size() * search(outcomes[first].revealed,
+										outcomes[first].key, part, NULL);
+		if(aborted) {
+			return 0.0;
+		}
+	}
+	return wins / layouts.size();
+}
+
+bool EndgameSolver::solve(char visible_field[][MAT_WIDTH], int height,
+							int width, int bombs, int& x, int& y,
+							double& win, double& mine) {
+	this->height = height;
+	this->width = width;
+	if(!collect(visible_field, bombs)) {
+		return false;
+	}
+
+	// the flags are the player's opinion, not part of the position
+	uint64_t key = zobrist_board(height, width, bombs);
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			char ch = visible_field[i][j];
+			if(ch != FLAGT) {
+				key ^= zobrist_tile(i, j, ch);
+			}
+		}
+	}
+
+	nodes = 0;
+	aborted = false;
+	deadline = std::chrono::steady_clock::now() +
+				std::chrono::milliseconds(time_limit_ms);
+	origin_x = x;
+	origin_y = y;
+	int move = -1;
+	win = search(0, key, layouts, &move);
+	if(aborted || move < 0) {
+		return false;
+	}
+
+	int mines = 0;
+	for(size_t k = 0; k < layouts.size(); k ++) {
+		mines += (layouts[k] >> move) & 1;
+	}
+	x = tiles[move] / MAT_WIDTH;
+	y = tiles[move] % MAT_WIDTH;
+	mine = (double)mines / layouts.size();
+	return true;
+}
@@ -0,0 +1,93 @@
+/**
+	EndgameSolver.h
+		Finds the move most likely to win the game, not only to survive the
+	next reveal, once few tiles are left unknown. The tiles the solver
+	proves mines are set aside; the mine layouts of the other hidden tiles
+	that agree with every number are listed as bit sets, and an expectimax
+	search plays every move on every layout: a reveal loses on the layouts
+	with a mine there and splits the others by what it shows (flood fill
+	included), each part a new position whose value is searched in turn.
+	The value of a position is remembered in a transposition table by its
+	Zobrist key, so positions met again, in whatever order their tiles
+	were revealed, are looked up. A tile safe on every layout is revealed
+	without trying the others, and the moves are tried from the safest on,
+	stopping at the first that can not beat the best value found (a move
+	never wins more often than it survives). The search gives up after a
+	number of positions, a time limit or when cancelled.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _ENDGAMESOLVER_H_
+#define _ENDGAMESOLVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <stdint.h>
+#include "Solver.h"
+#include "TranspositionTable.h"
+#include "Utils.h"
+
+// the most unknown tiles searched, and the positions one search may visit
+#define ENDGAME_MAX_TILES	20
+#define ENDGAME_NODE_LIMIT	200000
+// the values of the positions, 2^16 entries (1 MB)
+#define ENDGAME_TABLE_BITS	16
+
+
+class EndgameSolver {
+private:
+	int height;
+	int width;
+	Solver solver;
+	// the unknown tiles (x * MAT_WIDTH + y), their unknown neighbours as
+	// bits, and their neighbours proven mines
+	int nr_of_tiles;
+	int tiles[ENDGAME_MAX_TILES];
+	uint32_t neighbours[ENDGAME_MAX_TILES];
+	int fixed_mines[ENDGAME_MAX_TILES];
+	// the layouts agreeing with the field, bit t set for a mine on tiles[t]
+	std::vector<uint32_t> layouts;
+	// positions searched, their limit, and when to give up
+	long nodes;
+	long node_limit;
+	const std::atomic<bool>* cancel;
+	int time_limit_ms;
+	std::chrono::steady_clock::time_point deadline;
+	bool aborted;
+	// values of the positions, as floats
+	TranspositionTable table;
+	// the moves are tried closest to it first, among equally safe ones
+	int origin_x;
+	int origin_y;
+
+	// lists the unknown tiles and their layouts; false if there are too many
+	bool collect(char visible_field[][MAT_WIDTH], int bombs);
+	// chance to win from the position with the unknown tiles in revealed
+	// shown, key its Zobrist key and layouts the ones agreeing with it;
+	// move gets the best tile (an index of tiles), if not NULL
+	double search(uint32_t revealed, uint64_t key,
+					const std::vector<uint32_t>& layouts, int* move);
+	// chance to win by revealing tile t first
+	double play(uint32_t revealed, uint64_t key,
+				const std::vector<uint32_t>& layouts, int t);
+	bool out_of_budget();
+
+public:
+	EndgameSolver();
+
+	// positions one search may visit
+	void set_node_limit(long limit);
+	// the search gives up once the flag is set or after ms milliseconds
+	// (0 for no limit)
+	void set_cancel(const std::atomic<bool>* flag);
+	void set_time_limit(int ms);
+
+	// finds the move with the best chance to win, the closest to (x, y)
+	// among equals, and its chance of a mine; false if there are too many
+	// unknown tiles, no hidden tile, or the search went over its limits
+	bool solve(char visible_field[][MAT_WIDTH], int height, int width,
+				int bombs, int& x, int& y, double& win, double& mine);
+};
+
+#endif // _ENDGAMESOLVER_H_
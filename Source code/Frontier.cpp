@@ -0,0 +1,152 @@
+/**
+	Frontier.cpp
+		Contains the implementation of the functions declared in
+	'Frontier.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <algorithm>
+#include <cstdlib>
+#include "Frontier.h"
+
+
+Frontier::Frontier() :
+	bits((MAT_HEIGHT * MAT_WIDTH + 63) / 64, 0),
+	count(0)
+	{}
+
+void Frontier::clear() {
+	std::fill(bits.begin(), bits.end(), 0);
+	count = 0;
+}
+
+void Frontier::add(int x, int y) {
+	int i = index(x, y);
+	if(!(bits[i / 64] & (1ULL << (i % 64)))) {
+		bits[i / 64] |= 1ULL << (i % 64);
+		count ++;
+	}
+}
+
+void Frontier::remove(int x, int y) {
+	int i = index(x, y);
+	if(bits[i / 64] & (1ULL << (i % 64))) {
+		bits[i / 64] &= ~(1ULL << (i % 64));
+		count --;
+	}
+}
+
+bool Frontier::contains(int x, int y) const {
+	int i = index(x, y);
+	return bits[i / 64] & (1ULL << (i % 64));
+}
+
+int Frontier::size() const {
+	return count;
+}
+
+int Frontier::first_from(int i) const {
+	int w = i / 64;
+	if(w >= (int)bits.size()) {
+		return -1;
+	}
+	// the bits below i are masked off in its own word
+	uint64_t word = bits[w] & (~0ULL << (i % 64));
+	while(word == 0) {
+		if(++ w == (int)bits.size()) {
+			return -1;
+		}
+		word = bits[w];
+	}
+	return w * 64 + __builtin_ctzll(word);
+}
+
+int Frontier::last_until(int i) const {
+	if(i < 0) {
+		return -1;
+	}
+	int w = std::min(i / 64, (int)bits.size() - 1);
+	// the bits above i are masked off in its own word
+	uint64_t word = bits[w];
+	if(w == i / 64 && i % 64 != 63) {
+		word &= (1ULL << (i % 64 + 1)) - 1;
+	}
+	while(word == 0) {
+		if(-- w < 0) {
+			return -1;
+		}
+		word = bits[w];
+	}
+	return w * 64 + 63 - __builtin_clzll(word);
+}
+
+bool Frontier::next(int& x, int& y) const {
+	if(count == 0) {
+		return false;
+	}
+
+	int i = first_from(index(x, y) + 1);
+	if(i < 0) {
+		i = first_from(0);
+	}
+	x = i / MAT_WIDTH;
+	y = i % MAT_WIDTH;
+	return true;
+}
+
+// the rows are looked at going away from x, in each the closest tile on
+// both sides of y; no row further than the best tile found can beat it
+bool Frontier::nearest(int& x, int& y) const {
+	if(count == 0) {
+		return false;
+	}
+
+	int best = -1;
+	int best_distance = 0;
+	for(int d = 0; d < MAT_HEIGHT && (best < 0 || d < best_distance); d ++) {
+		for(int side = 0; side < 2; side ++) {
+			int r = side == 0 ? x - d : x + d;
+			if(r < 0 || r >= MAT_HEIGHT || (side == 1 && d == 0)) {
+				continue;
+			}
+			int after = first_from(index(r, y));
+			if(after > index(r, MAT_WIDTH - 1)) {
+				after = -1;
+			}
+			int before = last_until(index(r, y));
+			if(before < index(r, 0)) {
+				before = -1;
+			}
+
+			for(int k = 0; k < 2; k ++) {
+				int i = k == 0 ? after : before;
+				if(i < 0) {
+					continue;
+				}
+				int distance = std::max(d, std::abs(i % MAT_WIDTH - y));
+				if(best < 0 || distance < best_distance) {
+					best = i;
+					best_distance = distance;
+				}
+			}
+		}
+	}
+
+	x = best / MAT_WIDTH;
+	y = best % MAT_WIDTH;
+	return true;
+}
+
+bool Frontier::previous(int& x, int& y) const {
+	if(count == 0) {
+		return false;
+	}
+
+	int i = last_until(index(x, y) - 1);
+	if(i < 0) {
+		i = last_until(bits.size() * 64 - 1);
+	}
+	x = i / MAT_WIDTH;
+	y = i % MAT_WIDTH;
+	return true;
+}
@@ -0,0 +1,50 @@
+/**
+	Frontier.h
+		Index of the frontier of the board: the tiles that are neither
+	revealed nor flagged but touch a revealed number. It is kept up to date
+	by the game as tiles are revealed or flagged, so the cursor can jump
+	between the tiles worth looking at, or to the closest one. The tiles
+	are a bitset in reading order, the jumps scan it a 64-bit word at a
+	time, and nothing is allocated once the index is built.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _FRONTIER_H_
+#define _FRONTIER_H_
+
+#include <vector>
+#include <stdint.h>
+#include "Utils.h"
+
+
+class Frontier {
+private:
+	// one bit for every tile of the board (borders included)
+	std::vector<uint64_t> bits;
+	int count;
+
+	static int index(int x, int y) { return x * MAT_WIDTH + y; }
+	// the first tile at or after i, the last one at or before i; -1 if none
+	int first_from(int i) const;
+	int last_until(int i) const;
+
+public:
+	Frontier();
+
+	void clear();
+	void add(int x, int y);
+	void remove(int x, int y);
+	bool contains(int x, int y) const;
+	int size() const;
+	// moves (x, y) to the first frontier tile after it in reading order,
+	// wrapping around; returns false (leaving x, y unchanged) if empty
+	bool next(int& x, int& y) const;
+	// same as next, but backwards
+	bool previous(int& x, int& y) const;
+	// moves (x, y) to the frontier tile closest to it (the most rows or
+	// columns away), the rows closest to x first among equals; returns
+	// false (leaving x, y unchanged) if empty
+	bool nearest(int& x, int& y) const;
+};
+
+#endif // _FRONTIER_H_
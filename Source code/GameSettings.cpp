@@ -3,10 +3,31 @@
 
 	@author Sergiu Constantinescu
 */
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include "GameSettings.h"
+#include "Utils.h"
 
 
-GameSettings::GameSettings() {
+// the default presets, unless a presets file replaces them
+static const int default_presets[5][3] = {
+	{0, 0, 0},
+	{9, 9, 10},		// novice - 12.3% bombs
+	{14, 19, 42},	// adept - 15.6% bombs
+	{14, 34, 98},	// master - 20.65% bombs
+	{14, 68, 200}	// master (fullscreen) - 21% bombs
+};
+
+GameSettings::GameSettings() :
+	difficulty(1),
+	seed(0),
+	no_guess(false),
+	min_3bv(0),
+	max_3bv(0) {
+	memcpy(presets, default_presets, sizeof(presets));
 	// game starts with the easy default difficulty 
 	this->set_diff(1);
 }
@@ -19,40 +40,49 @@ void GameSettings::set_diff(int new_diff) {
 	if(new_diff > -1 && new_diff < 5) {
 		difficulty = new_diff;
 	}
-	switch(difficulty) {
-		case 0:
-			break;
-		case 1: // novice - 12.3% bombs
-			field_height = 9;
-			field_width = 9;
-			field_bombs = 10;
-			break;
-		case 2: // adept - 15.6% bombs
-			field_height = 14;
-			field_width = 19;
-			field_bombs = 42;
-			break;
-		case 3: // master - 20.65% bombs
-			field_height = 14;
-			field_width = 34;
-			field_bombs = 98;
-			break;
-		case 4: // master (fullscreen) - 21% bombs
-			field_height = 14;
-			field_width = 68;
-			field_bombs = 200;
-			break;
-		default:
-			field_height = 9;
-			field_width = 9;
-			field_bombs = 10;
+	if(difficulty > 0) {
+		field_height = presets[difficulty][0];
+		field_width = presets[difficulty][1];
+		field_bombs = presets[difficulty][2];
+	}
+	set_3bv_range(0, 0);
+}
+
+bool GameSettings::load_presets(const char* path) {
+	std::ifstream file(path);
+	if(!file) {
+		return false;
+	}
+
+	std::string line;
+	while(std::getline(file, line)) {
+		std::istringstream fields(line.substr(0, line.find('#')));
+		int preset, height, width, bombs;
+		if(!(fields >> preset >> height >> width >> bombs) ||
+			preset < 1 || preset > 4) {
+			continue;
+		}
+		height = std::min(std::max(height, MIN_HEIGHT), MAX_HEIGHT);
+		width = std::min(std::max(width, MIN_WIDTH), MAX_WIDTH);
+		presets[preset][0] = height;
+		presets[preset][1] = width;
+		presets[preset][2] = std::min(std::max(bombs, MIN_BOMBS),
+										max_bombs(height, width));
 	}
+	set_diff(difficulty);
+	return true;
 }
 
 void GameSettings::set_custom_diff(int height, int width, int bombs) {
-	field_height = height;
-	field_width = width;
-	field_bombs = bombs;
+	field_height = std::min(std::max(height, MIN_HEIGHT), MAX_HEIGHT);
+	field_width = std::min(std::max(width, MIN_WIDTH), MAX_WIDTH);
+	field_bombs = std::min(std::max(bombs, MIN_BOMBS),
+							max_bombs(field_height, field_width));
+	set_3bv_range(0, 0);
+}
+
+int GameSettings::max_bombs(int height, int width) {
+	return std::min((int)(height * width * MAX_DENSITY), height * width - 9);
 }
 
 int GameSettings::get_height() {
@@ -66,3 +96,36 @@ int GameSettings::get_width() {
 int GameSettings::get_bombs() {
 	return field_bombs;
 }
+
+uint64_t GameSettings::get_seed() {
+	return seed;
+}
+
+void GameSettings::set_seed(uint64_t new_seed) {
+	seed = new_seed;
+}
+
+bool GameSettings::get_no_guess() {
+	return no_guess;
+}
+
+void GameSettings::set_no_guess(bool new_no_guess) {
+	no_guess = new_no_guess;
+}
+
+bool GameSettings::no_guess_possible() {
+	return field_bombs <= NO_GUESS_MAX_DENSITY * field_height * field_width;
+}
+
+int GameSettings::get_min_3bv() {
+	return min_3bv;
+}
+
+int GameSettings::get_max_3bv() {
+	return max_3bv;
+}
+
+void GameSettings::set_3bv_range(int min, int max) {
+	min_3bv = min;
+	max_3bv = max;
+}
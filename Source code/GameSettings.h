@@ -6,6 +6,7 @@
 #ifndef _GAMESETTINGS_H_
 #define _GAMESETTINGS_H_
 
+#include <stdint.h>
 
 class GameSettings {
 private:
@@ -18,16 +19,43 @@ private:
 	int field_height;
 	int field_width;
 	int field_bombs;
+	// height, width and bombs of the presets 1 to 4 (0 is unused)
+	int presets[5][3];
+	// seed of the boards' random generator, 0 to seed it with the time
+	uint64_t seed;
+	// only boards that can be cleared without guessing
+	bool no_guess;
+	// only boards with a 3BV in this range, 0 for no limit; a range
+	// only fits one board size, so it is dropped when that changes
+	int min_3bv;
+	int max_3bv;
 
 public:
 	GameSettings();
 
 	int get_diff();
 	void set_diff(int new_diff);
+	// reads the presets from a file made by 'minesweeper-calibrate', with
+	// lines 'preset height width bombs' ('#' starts a comment); the
+	// presets it does not list are kept. False if it cannot be read
+	bool load_presets(const char* path);
+	// the values are brought within the limits in 'Utils.h'
 	void set_custom_diff(int height, int width, int bombs);
 	int get_height();
 	int get_width();
 	int get_bombs();
+	uint64_t get_seed();
+	void set_seed(uint64_t new_seed);
+	bool get_no_guess();
+	void set_no_guess(bool new_no_guess);
+	// no-guess boards are only made up to NO_GUESS_MAX_DENSITY bombs
+	bool no_guess_possible();
+	int get_min_3bv();
+	int get_max_3bv();
+	void set_3bv_range(int min, int max);
+	// the most bombs a height x width board can have: MAX_DENSITY of it,
+	// and never the 3x3 block opened by the first reveal
+	static int max_bombs(int height, int width);
 };
 
 #endif // _GAMESETTINGS_H_
@@ -12,8 +12,14 @@
 #ifndef _GAMESTATE_H_
 #define _GAMESTATE_H_
 
+#include <random>
 #include "GameSettings.h"
 #include "Utils.h"
+#include "Frontier.h"
+#include "Solver.h"
+#include "HintWorker.h"
+#include "WinEstimator.h"
+#include "BoardGenerator.h"
 
 
 template <class IO>
@@ -34,19 +40,64 @@ private:
 	double percentage_disc;
 	bool quit_game;
 	bool game_not_over;
+	// hidden, unflagged tiles next to revealed numbers
+	Frontier frontier;
+	// generator of the boards' seeds, as wide as the seed it starts from
+	std::mt19937_64 rng;
+	// the bombs are only placed at the first reveal, away from it
+	BoardGenerator generator;
+	bool no_guess;
+	bool bbbv_range;
+	bool board_ready;
+	// shown once the board is drawn, NULL for none
+	const char* notice;
+	// finds the tiles that are provably safe or mines, loaded with the
+	// board and told about every reveal since
+	Solver solver;
+	// hints are computed on a thread of their own and shown as they come
+	HintWorker hints;
+	bool hint_pending;
+	// the chance to win is estimated by playouts on all cores, until the
+	// board changes
+	WinEstimator estimator;
+	bool estimate_pending;
+	int estimate_tiles;
+	// asked for and not taken off the status yet
+	bool estimate_shown;
 
 public:
 	GameState(IO* io_mod);
 
 	void reset_game();
+	// clears the board and generates a new one
+	void new_board();
 	void game_loop(GameSettings *settings);
+	// prepares a new game without the game loop, for programmatic play
+	void start_game(GameSettings *settings);
+	// reveals the tile at (x, y), as if the player moved the cursor
+	// there and pressed space; returns the event of check_tile
+	int click(int x, int y);
+	int reveal_at_cursor();
+	bool is_won();
+	bool is_lost();
+	char (*get_visible_field())[MAT_WIDTH];
+	int get_height();
+	int get_width();
+	int get_bombs();
+	double get_percent_solved();
+	// applies the action bound to a key
+	void handle_input(char input);
 	// actions that need to be done when the game ends
 	void game_over(bool won);
 	void reveal_bombs();
 	void set_borders();
-	void place_bombs();
+	// places the bombs, none in the 3x3 block around the first reveal (x, y)
+	void generate_board(int x, int y);
 	void plant_flag();
 	void reveal_tile(int x, int y);
+	// keeps the frontier up to date after a tile was revealed
+	void update_frontier(int x, int y);
+	bool next_to_number(int x, int y);
 	int check_tile();
 	void move_up();
 	void move_down();
@@ -56,6 +107,20 @@ public:
 	// extracts the settings from the settings object as separate values
 	void get_settings(GameSettings *settings);
 	void quit();
+	// asks for the closest provably safe tile, or for the tile least
+	// likely to be a mine if there is none
+	void show_hint();
+	// moves the cursor to the newest answer and shows it; false if
+	// there was nothing new
+	bool apply_hint();
+	// starts estimating the chance to win from the current position
+	void show_win_chance();
+	// shows how far the estimate got
+	void apply_estimate();
+	// stops the estimate and takes it off the status
+	void clear_estimate();
+	// reveals provably safe tiles until none is left
+	void auto_solve();
 };
 
 #include "GameState.hpp"
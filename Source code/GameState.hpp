@@ -8,6 +8,7 @@
 #ifndef __GAMESTATE_HPP_
 #define __GAMESTATE_HPP_
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
@@ -26,24 +27,40 @@ GameState<IO>::GameState(IO* io_mode) :
 	safe_tiles(37),
 	percentage_disc(0.0),
 	quit_game(false),
-	game_not_over(true)
+	game_not_over(true),
+	generator(0),
+	no_guess(false),
+	bbbv_range(false),
+	board_ready(false),
+	notice(NULL),
+	hint_pending(false),
+	estimator(0),
+	estimate_pending(false),
+	estimate_tiles(0),
+	estimate_shown(false)
 	{}
 
 template <class IO>
 void GameState<IO>::reset_game() {
-	for(int i = 0; i < MAT_HEIGHT; i ++) {
-		for(int j = 0; j < MAT_WIDTH; j ++) {
+	// only the current board (with its borders) is ever read
+	for(int i = 0; i < height + 2; i ++) {
+		for(int j = 0; j < width + 2; j ++) {
 			visible_field[i][j] = EMPTYH;
 			hidden_field[i][j] = EMPTYH;
 		}
 	}
 
 	game_not_over = true;
+	notice = NULL;
 	discovered_tiles = 0;
 	percentage_disc = 0.0;
 	marked_tiles = 0;
 	cursor_x = 1;
 	cursor_y = 1;
+	frontier.clear();
+	hints.cancel();
+	hint_pending = false;
+	clear_estimate();
 }
 
 // The game's loop, it can be generally described by the following steps:
@@ -62,10 +79,7 @@ void GameState<IO>::game_loop(GameSettings *settings) {
 	get_settings(settings);
 	io_mode->io_update_settings(settings);
 	io_mode->init_IO(false);
-	reset_game();
-	place_bombs();
-	place_numbers();
-	set_borders();
+	new_board();
 
 	game_not_over = true;
 	quit_game = false;
@@ -78,42 +92,54 @@ void GameState<IO>::game_loop(GameSettings *settings) {
 
 	while(game_not_over) {
 
-		input = io_mode->read_char();
-		switch(input) {
-			case 'w':
-				move_up();
-				break;
-			case 's':
-				move_down();
-				break;
-			case 'a':
-				move_left();
-				break;
-			case 'd':
-				move_right();
-				break;
-			case ' ': {
-				int event = check_tile();
-				if(event != 0) { // clicked on flag, nothing happens
-					if(event == -1) { // lose condition
-						game_not_over = false;
-					} else {
-						reveal_tile(cursor_x, cursor_y);
-						percentage_disc = ((double)discovered_tiles / 
-											(nr_of_tiles - bombs)) * 100.00;
+		// while a hint is computed, its answers are shown as they come
+		// (and so is the estimate of the chance to win)
+		if(hint_pending || estimate_pending) {
+			input = io_mode->wait_char(HINT_POLL_MS);
+			if(input == 0) {
+				// a script does not type meanwhile, the answers are
+				// waited for instead of polled
+				if(io_mode->is_scripted()) {
+					if(hint_pending) {
+						hints.wait();
+					}
+					if(estimate_pending) {
+						estimator.wait();
 					}
 				}
-				break;
+				if(hint_pending) {
+					apply_hint();
+				}
+				if(estimate_pending) {
+					apply_estimate();
+				}
+				continue;
 			}
-			case 'e':
-				plant_flag();
-				break;
-			case 'q':
-				// among other things, sets the value of quit_game to True
-				quit();
-				break;
-			default:
+		} else {
+			input = io_mode->read_char();
+		}
+
+		// the keys pressed while the board was being drawn are all
+		// applied before it is drawn again, stopping at the end of the game
+		while(input != 0) {
+			// any key makes the hint being computed stale
+			if(hint_pending) {
+				hints.cancel();
+				hint_pending = false;
+			}
+			handle_input(input);
+			// the estimate only holds for the board it was asked for
+			if(estimate_shown && discovered_tiles != estimate_tiles) {
+				clear_estimate();
+			}
+			// the board is drawn after a hint is asked for, the keys after
+			// it are read while it is computed; a key already waiting (in
+			// text mode, the rest of the line) cancels it before it shows
+			if(quit_game || !game_not_over || discovered_tiles == safe_tiles ||
+				hint_pending) {
 				break;
+			}
+			input = io_mode->poll_char();
 		}
 
 		if(!quit_game) {
@@ -123,6 +149,10 @@ void GameState<IO>::game_loop(GameSettings *settings) {
 										cursor_y, 
 										marked_tiles, 
 										percentage_disc);
+				if(notice != NULL) {
+					io_mode->print_str(notice);
+					notice = NULL;
+				}
 			} else {
 				// false parameter means the game was lost
 				game_over(false);
@@ -139,14 +169,144 @@ void GameState<IO>::game_loop(GameSettings *settings) {
 	io_mode->close_IO();
 }
 
+template <class IO>
+void GameState<IO>::new_board() {
+	reset_game();
+	// the bombs wait for the first reveal
+	board_ready = false;
+	set_borders();
+	// kept up to date by reveal_tile from now on
+	solver.load(visible_field, height, width);
+}
+
+template <class IO>
+void GameState<IO>::start_game(GameSettings *settings) {
+	get_settings(settings);
+	new_board();
+	game_not_over = true;
+	quit_game = false;
+}
+
+template <class IO>
+int GameState<IO>::click(int x, int y) {
+	cursor_x = x;
+	cursor_y = y;
+	return reveal_at_cursor();
+}
+
+template <class IO>
+int GameState<IO>::reveal_at_cursor() {
+	if(!board_ready && visible_field[cursor_x][cursor_y] != FLAGT) {
+		generate_board(cursor_x, cursor_y);
+	}
+
+	int event = check_tile();
+	if(event != 0) { // clicked on flag, nothing happens
+		if(event == -1) { // lose condition
+			game_not_over = false;
+		} else {
+			reveal_tile(cursor_x, cursor_y);
+			percentage_disc = ((double)discovered_tiles / 
+								(nr_of_tiles - bombs)) * 100.00;
+		}
+	}
+	return event;
+}
+
+template <class IO>
+bool GameState<IO>::is_won() {
+	return discovered_tiles == safe_tiles;
+}
+
+template <class IO>
+bool GameState<IO>::is_lost() {
+	return !game_not_over && discovered_tiles != safe_tiles;
+}
+
+template <class IO>
+char (*GameState<IO>::get_visible_field())[MAT_WIDTH] {
+	return visible_field;
+}
+
+template <class IO>
+int GameState<IO>::get_height() {
+	return height;
+}
+
+template <class IO>
+int GameState<IO>::get_width() {
+	return width;
+}
+
+template <class IO>
+int GameState<IO>::get_bombs() {
+	return bombs;
+}
+
+template <class IO>
+double GameState<IO>::get_percent_solved() {
+	return percentage_disc;
+}
+
+template <class IO>
+void GameState<IO>::handle_input(char input) {
+	switch(input) {
+		case 'w':
+			move_up();
+			break;
+		case 's':
+			move_down();
+			break;
+		case 'a':
+			move_left();
+			break;
+		case 'd':
+			move_right();
+			break;
+		case ' ':
+			reveal_at_cursor();
+			break;
+		case 'e':
+			plant_flag();
+			break;
+		case 'n':
+			frontier.next(cursor_x, cursor_y);
+			break;
+		case 'b':
+			frontier.previous(cursor_x, cursor_y);
+			break;
+		case 'f':
+			frontier.nearest(cursor_x, cursor_y);
+			break;
+		case 'h':
+			show_hint();
+			break;
+		case 'c':
+			show_win_chance();
+			break;
+		case 'r':
+			auto_solve();
+			break;
+		case 'q':
+			// among other things, sets the value of quit_game to True
+			quit();
+			break;
+		default:
+			break;
+	}
+}
+
 // reveals the board, prints game over message and 
 // asks the player if they want to start a new game
-// (if the answer is yes, it also resets the game)
+// (if the answer is yes, it also resets the game); meanwhile the cursor
+// still moves, to look at the parts of a large board out of view
 template <class IO>
 void GameState<IO>::game_over(bool won) {
 	
+	// the chance to win is of no use any more
+	clear_estimate();
 	reveal_bombs();
-	io_mode->print_revealed_board(visible_field, won);
+	io_mode->print_revealed_board(visible_field, won, cursor_x, cursor_y);
 	if(won) {
 		io_mode->print_win_message();
 	} else {
@@ -157,10 +317,7 @@ void GameState<IO>::game_over(bool won) {
 	while(true) {
 		input = io_mode->read_char();
 		if(input == 'y') {
-			reset_game();
-			place_bombs();
-			place_numbers();
-			set_borders();
+			new_board();
 			io_mode->print_board(visible_field,
 									cursor_x,
 									cursor_y,
@@ -170,6 +327,9 @@ void GameState<IO>::game_over(bool won) {
 		} else if (input == 'n'){
 			game_not_over = false;
 			break;
+		} else if(input == 'w' || input == 's' || input == 'a' || input == 'd') {
+			handle_input(input);
+			io_mode->print_revealed_board(visible_field, won, cursor_x, cursor_y);
 		}
 	}
 }
@@ -211,23 +371,27 @@ void GameState<IO>::set_borders() {
 	}
 }
 
-// randomly (using device's time as seed) populates the game board
-// with mines.
+// randomly populates the game board with mines, the first reveal opens
+// (the generator is seeded by get_settings)
 template <class IO>
-void GameState<IO>::place_bombs() {
-	int bombs_left = this->bombs;
-	int bomb_x, bomb_y;
-	srand(time(NULL));
-
-	while(bombs_left) {
-		bomb_y = (rand() % (this->width)) + 1;
-		bomb_x = (rand() % (this->height)) + 1;
-
-		if(hidden_field[bomb_x][bomb_y] == EMPTYH) {
-			hidden_field[bomb_x][bomb_y] = BOMBT;
-			bombs_left --;
+void GameState<IO>::generate_board(int x, int y) {
+	uint64_t seed = rng();
+	// the search may take up to its time limit
+	if(no_guess || bbbv_range) {
+		io_mode->print_str("Looking for a board...");
+	}
+	if(!generator.generate(hidden_field, height, width, bombs, x, y, seed,
+							no_guess)) {
+		if(!bbbv_range) {
+			notice = "No no-guess board found in time, this one may need guesses";
+		} else if(!no_guess) {
+			notice = "No board in the 3BV range found in time, this one is random";
+		} else {
+			notice = "No no-guess board in the 3BV range found in time, random board";
 		}
 	}
+	place_numbers();
+	board_ready = true;
 }
 
 // plants/removes the flag (marked with FLAGT, defined in 'Utils.h')
@@ -238,9 +402,13 @@ void GameState<IO>::plant_flag() {
 	if(visible_field[cursor_x][cursor_y] == EMPTYH) {
 		visible_field[cursor_x][cursor_y] = FLAGT;
 		marked_tiles++;
+		frontier.remove(cursor_x, cursor_y);
 	} else if(visible_field[cursor_x][cursor_y] == FLAGT) {
 		visible_field[cursor_x][cursor_y] = EMPTYH;
 		marked_tiles--;
+		if(next_to_number(cursor_x, cursor_y)) {
+			frontier.add(cursor_x, cursor_y);
+		}
 	}
 }
 
@@ -254,6 +422,8 @@ void GameState<IO>::reveal_tile(int x, int y) {
 		}
 		visible_field[x][y] = EMPTYD;
 		hidden_field[x][y] = EMPTYD;
+		frontier.remove(x, y);
+		solver.update(x, y);
 		// up
 		if(x > 1) {
 			reveal_tile(x - 1, y);
@@ -293,8 +463,36 @@ void GameState<IO>::reveal_tile(int x, int y) {
 		if(visible_field[x][y] != hidden_field[x][y]) {
 			visible_field[x][y] = hidden_field[x][y];
 			discovered_tiles ++;
+			update_frontier(x, y);
+			solver.update(x, y);
+		}
+	}
+}
+
+// a revealed number leaves the frontier and brings its hidden,
+// unflagged neighbours in
+template <class IO>
+void GameState<IO>::update_frontier(int x, int y) {
+	frontier.remove(x, y);
+	for(int i = x - 1; i <= x + 1; i ++) {
+		for(int j = y - 1; j <= y + 1; j ++) {
+			if(visible_field[i][j] == EMPTYH) {
+				frontier.add(i, j);
+			}
+		}
+	}
+}
+
+template <class IO>
+bool GameState<IO>::next_to_number(int x, int y) {
+	for(int i = x - 1; i <= x + 1; i ++) {
+		for(int j = y - 1; j <= y + 1; j ++) {
+			if(visible_field[i][j] > '0' && visible_field[i][j] < '9') {
+				return true;
+			}
 		}
 	}
+	return false;
 }
 
 // checks if the player tries to check a mined tile
@@ -426,9 +624,19 @@ void GameState<IO>::get_settings(GameSettings *settings) {
 	height = settings->get_height();
 	width = settings->get_width();
 	bombs = settings->get_bombs();
+	no_guess = settings->get_no_guess() && settings->no_guess_possible();
+	bbbv_range = settings->get_min_3bv() > 0 || settings->get_max_3bv() > 0;
+	generator.set_3bv_range(settings->get_min_3bv(), settings->get_max_3bv());
 
 	nr_of_tiles = (height) * (width);
 	safe_tiles = nr_of_tiles - bombs;
+
+	// the same seed always leads to the same boards
+	if(settings->get_seed() != 0) {
+		rng.seed(settings->get_seed());
+	} else {
+		rng.seed(time(NULL));
+	}
 }
 
 template <class IO>
@@ -450,4 +658,127 @@ void GameState<IO>::quit() {
 	}
 }
 
+template <class IO>
+void GameState<IO>::show_hint() {
+	hints.request(solver, visible_field, height, width, bombs,
+					cursor_x, cursor_y, HINT_BUDGET_MS);
+	hint_pending = true;
+}
+
+template <class IO>
+bool GameState<IO>::apply_hint() {
+	HintWorker::hint answer;
+	char message[64];
+
+	// the last answer is published before the request is marked as done
+	hint_pending = hints.busy();
+	if(!hints.poll(answer)) {
+		return false;
+	}
+
+	cursor_x = answer.x;
+	cursor_y = answer.y;
+	io_mode->print_board(visible_field,
+							cursor_x,
+							cursor_y,
+							marked_tiles,
+							percentage_disc);
+	switch(answer.type) {
+		case HintWorker::HINT_SAFE:
+			snprintf(message, sizeof(message), "Hint: this tile is safe");
+			break;
+		case HintWorker::HINT_GUESS:
+			snprintf(message, sizeof(message),
+						"Hint: best guess, %.1f%% chance of a mine",
+						answer.probability * 100.0);
+			break;
+		case HintWorker::HINT_BEST:
+			snprintf(message, sizeof(message),
+						"Hint: best move, %.1f%% to win (%.1f%% of a mine)",
+						answer.win * 100.0, answer.probability * 100.0);
+			break;
+		default:
+			snprintf(message, sizeof(message), "Hint: no answer in time");
+			break;
+	}
+	io_mode->print_str(message);
+	return true;
+}
+
+template <class IO>
+void GameState<IO>::show_win_chance() {
+	// the answer is shown once the board was drawn again
+	estimate_pending = true;
+	estimate_shown = true;
+	estimate_tiles = discovered_tiles;
+	if(!board_ready) {
+		return;
+	}
+	estimator.request(visible_field, height, width, bombs,
+						cursor_x, cursor_y, rng());
+}
+
+template <class IO>
+void GameState<IO>::apply_estimate() {
+	WinEstimator::estimate answer = estimator.get();
+	char message[64];
+
+	estimate_pending = answer.running;
+	if(!board_ready) {
+		snprintf(message, sizeof(message), "Win chance: reveal a tile first");
+		estimate_pending = false;
+	} else if(answer.failed) {
+		snprintf(message, sizeof(message), "Win chance: too many layouts");
+		estimate_pending = false;
+	} else if(answer.playouts == 0) {
+		snprintf(message, sizeof(message), "Win chance: ...");
+	} else {
+		snprintf(message, sizeof(message),
+					"Win chance %.1f%% (%.1f - %.1f), %llu games%s",
+					answer.chance * 100.0, answer.low * 100.0,
+					answer.high * 100.0, (unsigned long long)answer.playouts,
+					answer.running ? "..." : "");
+	}
+	io_mode->print_estimate(message);
+}
+
+template <class IO>
+void GameState<IO>::clear_estimate() {
+	estimator.cancel();
+	estimate_pending = false;
+	if(estimate_shown) {
+		io_mode->print_estimate("");
+		estimate_shown = false;
+	}
+}
+
+template <class IO>
+void GameState<IO>::auto_solve() {
+	int x = cursor_x;
+	int y = cursor_y;
+
+	// the reveals extend the list of safe tiles as the solver goes on
+	size_t next = 0;
+	solver.solve();
+	while(game_not_over && discovered_tiles != safe_tiles) {
+		const std::vector<int>& safe = solver.get_safe_tiles();
+		if(next == safe.size()) {
+			if(solver.solve() == 0) {
+				break;
+			}
+			continue;
+		}
+
+		int tx = safe[next] / MAT_WIDTH;
+		int ty = safe[next] % MAT_WIDTH;
+		next ++;
+		if(visible_field[tx][ty] == EMPTYH) {
+			click(tx, ty);
+		}
+	}
+
+	cursor_x = x;
+	cursor_y = y;
+}
+
 #endif // __GAMESTATE_HPP_
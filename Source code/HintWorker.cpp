@@ -0,0 +1,218 @@
+/**
+	HintWorker.cpp
+		Contains the implementation of the functions declared in
+	'HintWorker.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <cstring>
+#include "HintWorker.h"
+
+
+HintWorker::HintWorker() :
+	quit(false),
+	generation(0),
+	cancelled(false),
+	job_ready(false),
+	working(false),
+	fresh(false)
+	{
+	next_job.height = 0;
+	next_job.width = 0;
+	next_job.bombs = 0;
+	next_job.cursor_x = 1;
+	next_job.cursor_y = 1;
+	next_job.budget_ms = HINT_BUDGET_MS;
+	probability.set_cancel(&cancelled);
+	endgame.set_cancel(&cancelled);
+}
+
+HintWorker::~HintWorker() {
+	if(thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			quit = true;
+			cancelled = true;
+		}
+		wake.notify_one();
+		thread.join();
+	}
+}
+
+void HintWorker::request(const Solver& kept, char visible_field[][MAT_WIDTH],
+							int height, int width, int bombs, int x, int y,
+							int budget_ms) {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		for(int i = 0; i < height + 2; i ++) {
+			memcpy(next_field[i], visible_field[i], width + 2);
+		}
+		// the deductions so far are kept, only the last moves are left
+		next_solver = kept;
+		next_job.height = height;
+		next_job.width = width;
+		next_job.bombs = bombs;
+		next_job.cursor_x = x;
+		next_job.cursor_y = y;
+		next_job.budget_ms = budget_ms;
+
+		generation ++;
+		cancelled = true;
+		job_ready = true;
+		working = true;
+		fresh = false;
+	}
+
+	// started with the first hint, most games never ask for one
+	if(!thread.joinable()) {
+		thread = std::thread(&HintWorker::run, this);
+	}
+	wake.notify_one();
+}
+
+void HintWorker::cancel() {
+	std::lock_guard<std::mutex> guard(lock);
+	generation ++;
+	cancelled = true;
+	job_ready = false;
+	working = false;
+	fresh = false;
+}
+
+bool HintWorker::poll(hint& answer) {
+	std::lock_guard<std::mutex> guard(lock);
+	if(!fresh) {
+		return false;
+	}
+	answer = latest;
+	fresh = false;
+	return true;
+}
+
+bool HintWorker::busy() {
+	std::lock_guard<std::mutex> guard(lock);
+	return working;
+}
+
+void HintWorker::wait() {
+	std::unique_lock<std::mutex> guard(lock);
+	while(working) {
+		done.wait(guard);
+	}
+}
+
+bool HintWorker::publish(unsigned request, const hint& answer) {
+	std::lock_guard<std::mutex> guard(lock);
+	if(request != generation) {
+		return false;
+	}
+	latest = answer;
+	fresh = true;
+	return true;
+}
+
+void HintWorker::run() {
+	std::unique_lock<std::mutex> guard(lock);
+
+	while(true) {
+		while(!quit && !job_ready) {
+			wake.wait(guard);
+		}
+		if(quit) {
+			return;
+		}
+
+		// the field is copied again, the game may send a newer one meanwhile
+		job_ready = false;
+		cancelled = false;
+		unsigned request = generation;
+		job current = next_job;
+		for(int i = 0; i < current.height + 2; i ++) {
+			memcpy(field[i], next_field[i], current.width + 2);
+		}
+		solver = next_solver;
+		solver.attach(field);
+
+		guard.unlock();
+		search(request, current);
+		guard.lock();
+
+		if(request == generation) {
+			working = false;
+			done.notify_all();
+		}
+	}
+}
+
+void HintWorker::search(unsigned request, const job& current) {
+	hint answer;
+	int x = current.cursor_x;
+	int y = current.cursor_y;
+
+	// the single number rules and the patterns, on a copy since the tiles
+	// they leave to the pair rules are taken off its work list
+	quick = solver;
+	quick.use_pair_rules(false);
+	quick.solve();
+	if(quick.closest_safe(x, y)) {
+		answer.type = HINT_SAFE;
+		answer.x = x;
+		answer.y = y;
+		answer.probability = 0.0;
+		answer.win = -1.0;
+		if(!publish(request, answer)) {
+			return;
+		}
+	}
+
+	// all the deterministic rules, a closer safe tile may show up
+	x = current.cursor_x;
+	y = current.cursor_y;
+	solver.use_pair_rules(true);
+	solver.solve();
+	if(solver.closest_safe(x, y)) {
+		answer.type = HINT_SAFE;
+		answer.x = x;
+		answer.y = y;
+		answer.probability = 0.0;
+		answer.win = -1.0;
+		publish(request, answer);
+		return;
+	}
+	if(cancelled) {
+		return;
+	}
+
+	// nothing is provably safe, the best guess if found in time
+	x = current.cursor_x;
+	y = current.cursor_y;
+	probability.set_time_limit(current.budget_ms);
+	answer.win = -1.0;
+	if(probability.compute(field, current.height, current.width, current.bombs) &&
+		probability.safest(x, y)) {
+		answer.type = HINT_GUESS;
+		answer.x = x;
+		answer.y = y;
+		answer.probability = probability.get_probability(x, y);
+	} else {
+		answer.type = HINT_NONE;
+		answer.x = current.cursor_x;
+		answer.y = current.cursor_y;
+		answer.probability = 1.0;
+	}
+	if(!publish(request, answer)) {
+		return;
+	}
+
+	// the safest tile is not always the best move near the end
+	x = current.cursor_x;
+	y = current.cursor_y;
+	endgame.set_time_limit(current.budget_ms);
+	if(endgame.solve(field, current.height, current.width, current.bombs,
+						x, y, answer.win, answer.probability)) {
+		answer.type = HINT_BEST;
+		answer.x = x;
+		answer.y = y;
+		publish(request, answer);
+	}
+}
@@ -0,0 +1,112 @@
+/**
+	HintWorker.h
+		Computes hints on a thread of its own, so the game never waits for
+	the solver. A request copies the visible field and the solver the game
+	keeps up to date at every reveal, and cancels the one before it. The
+	answers get better as the worker goes: the closest safe tile found by
+	the single number rules and the patterns, then by the pair rules too
+	and, if nothing is provably safe, the tile least likely
+	to be a mine, from the exact probabilities, as long as they fit in the
+	time budget of the request. Once few tiles are unknown, the endgame
+	search then looks for the move most likely to win the game.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _HINTWORKER_H_
+#define _HINTWORKER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Solver.h"
+#include "Probability.h"
+#include "EndgameSolver.h"
+#include "Utils.h"
+
+// time the exact probabilities may take for a hint
+#define HINT_BUDGET_MS	1000
+// how often the game looks for new answers while a hint is computed
+#define HINT_POLL_MS	20
+
+
+class HintWorker {
+public:
+	enum hint_type {
+		HINT_NONE,		// nothing found within the budget
+		HINT_SAFE,		// provably safe tile
+		HINT_GUESS,		// tile least likely to be a mine
+		HINT_BEST		// move most likely to win, among few unknown tiles
+	};
+	struct hint {
+		hint_type type;
+		int x;
+		int y;
+		// chance of a mine under the tile
+		double probability;
+		// chance to win after the move (HINT_BEST only)
+		double win;
+	};
+
+private:
+	// what a search works on, besides the field
+	struct job {
+		int height;
+		int width;
+		int bombs;
+		int cursor_x;
+		int cursor_y;
+		int budget_ms;
+	};
+
+	std::thread thread;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	bool quit;
+	// the request being worked on; older requests are discarded
+	unsigned generation;
+	std::atomic<bool> cancelled;
+	bool job_ready;
+	bool working;
+	// the newest answer, and whether it was already polled
+	hint latest;
+	bool fresh;
+
+	// the field of the next request, and the one being worked on
+	char next_field[MAT_HEIGHT][MAT_WIDTH];
+	char field[MAT_HEIGHT][MAT_WIDTH];
+	// the rest of the next request, under the lock like its field
+	job next_job;
+	// the game's solver at the next request, and the copies searching:
+	// one without the pair rules for a first answer, one with them
+	Solver next_solver;
+	Solver quick;
+	Solver solver;
+	ProbabilityEngine probability;
+	EndgameSolver endgame;
+
+	void run();
+	void search(unsigned request, const job& current);
+	// false if the request is outdated
+	bool publish(unsigned request, const hint& answer);
+
+public:
+	HintWorker();
+	~HintWorker();
+
+	// starts looking for a hint around (x, y), cancelling the older request;
+	// kept is the solver of visible_field, as the game keeps it
+	void request(const Solver& kept, char visible_field[][MAT_WIDTH],
+					int height, int width, int bombs, int x, int y,
+					int budget_ms);
+	void cancel();
+	// the newest answer to the current request, if not polled yet
+	bool poll(hint& answer);
+	// true until the current request is done
+	bool busy();
+	// blocks until the current request is done
+	void wait();
+};
+
+#endif // _HINTWORKER_H_
@@ -15,16 +15,26 @@
 class IOInterface {
 public:
 	virtual char read_char() = 0;
+	// returns a key that was already pressed, or 0 without waiting
+	virtual char poll_char() = 0;
+	// waits at most ms milliseconds for a key, returns 0 if none came
+	virtual char wait_char(int ms) = 0;
+	// true if the keys come from a script: nobody waits for the screen,
+	// so the game waits for its background work instead of polling it
+	virtual bool is_scripted() = 0;
 	virtual std::string read_string() = 0;
 	virtual int read_int() = 0;
 	// added for future cross platform compatibility
 	virtual void print_clear() = 0;
 	virtual void io_update_settings(GameSettings* settings) = 0;
 	virtual void print_menu(int menu_level) = 0;
-	virtual void print_str(std::string message) = 0;
-	virtual void println_str(std::string message) = 0;
+	virtual void print_str(const char* message) = 0;
+	// shown with the statistics of the board, without erasing them, until
+	// replaced; an empty message takes it off
+	virtual void print_estimate(const char* message) = 0;
+	virtual void println_str(const char* message) = 0;
 	virtual void print_header() = 0;
-	virtual void print_diff_constraints(std::string name, int min, int max, bool err) = 0;
+	virtual void print_diff_constraints(const char* name, int min, int max, bool err) = 0;
 	virtual void print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y, int marked, double percent) = 0;
 	virtual void print_win_message() = 0;
 	virtual void print_lose_message() = 0;
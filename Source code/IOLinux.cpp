@@ -7,34 +7,78 @@
 */
 #include <ncurses.h>
 #include <string>
-#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
 #include "IOLinux.h"
 #include "GameSettings.h"
 #include "Utils.h"
 
 IOLinux::IOLinux(GameSettings* settings):
 	settings(settings),
+	header(NULL),
+	screen(NULL),
+	bottom(NULL),
 	k_print_clear(
 	"                                                                    "),
 	k_input_clear(
 	">                                                                   "),
 	k_header_height(3),
-	k_menu_height(16),
+	// the rules, the back option and the borders
+	k_menu_height((int)rules.size() + 3),
 	k_menu_width(70),
 	k_bottom_height(4),
 	k_options_pos_x(28),
 	k_prompt('>'),
-	k_cursor('+')
-	{}
+	k_cursor('+'),
+	session_started(false),
+	board_pad(NULL),
+	view_y(0),
+	view_x(0),
+	view_height(0),
+	view_width(0),
+	view_dirty(true),
+	menu_screen(true),
+	last_menu_level(0),
+	last_field(NULL),
+	last_c_x(1),
+	last_c_y(1),
+	last_revealed(false),
+	last_won(false),
+	last_marked(0),
+	last_percent(0.0),
+	stats_valid(false)
+	{
+	estimate_line[0] = '\0';
+}
 
-WINDOW* IOLinux::create_win(int hei, int wid, int start_x, int start_y) {
-	WINDOW *win;
+IOLinux::~IOLinux() {
+	if(session_started) {
+		destroy_win(header);
+		destroy_win(screen);
+		destroy_win(bottom);
+		if(board_pad != NULL) {
+			delwin(board_pad);
+		}
+		endwin();
+	}
+}
 
-	win = newwin(hei, wid, start_y, start_x);
+// creates the window the first time, afterwards it only moves and resizes
+// it; the window is boxed but the terminal is updated later, at once
+void IOLinux::place_win(WINDOW*& win, const win_params& params) {
+	if(win == NULL) {
+		win = newwin(params.height, params.width, params.start_y, params.start_x);
+	} else {
+		// shrunk first so that the move can not take it off the screen
+		wresize(win, 1, 1);
+		mvwin(win, params.start_y, params.start_x);
+		wresize(win, params.height, params.width);
+	}
+	werase(win);
 	box(win, 0 , 0);
-	wrefresh(win);
-
-	return win;
+	wnoutrefresh(win);
 }
 
 void IOLinux::destroy_win(WINDOW* win) {
@@ -43,17 +87,38 @@ void IOLinux::destroy_win(WINDOW* win) {
 	delwin(win);
 }
 
+// the ncurses session and the windows live as long as this object, a screen
+// change only lays the windows out again
 void IOLinux::init_IO(bool menu_type_scr) {
-	initscr();
-	curs_set(0);
-	init_colors();
-	refresh();
+	if(!session_started) {
+		initscr();
+		curs_set(0);
+		init_colors();
+		session_started = true;
+	}
+
+	menu_screen = menu_type_scr;
+	last_field = NULL;
+	last_revealed = false;
+	if(!menu_screen) {
+		if(board_pad == NULL) {
+			board_pad = newpad(settings->get_height(), settings->get_width());
+		} else {
+			wresize(board_pad, settings->get_height(), settings->get_width());
+		}
+		view_y = 0;
+		view_x = 0;
+		invalidate_frame();
+	}
+	layout_windows();
+}
 
+void IOLinux::layout_windows() {
 	header_params.start_y = 0;
 	header_params.start_x = 0;
 	header_params.height = k_header_height;
 	header_params.width = k_menu_width;
-	if(menu_type_scr) { // to create a menu window
+	if(menu_screen) { // to create a menu window
 		screen_params.start_y = header_params.height;
 		screen_params.start_x = 0;
 		screen_params.height = k_menu_height;
@@ -64,43 +129,57 @@ void IOLinux::init_IO(bool menu_type_scr) {
 		bottom_params.height = k_bottom_height;
 		bottom_params.width = k_menu_width;
 	} else { // to create a game window
+		// the viewport is as large as the board, or as the terminal allows
+		int free_height = LINES - k_header_height - k_bottom_height - 2;
+		int free_width = COLS - 2;
+		view_height = std::max(1, std::min(settings->get_height(), free_height));
+		view_width = std::max(1, std::min(settings->get_width(), free_width));
+
 		screen_params.start_y = header_params.height;
-		screen_params.start_x = (MAT_WIDTH - settings->get_width() - 3)/2;
-		screen_params.height = settings->get_height() + 2;
-		screen_params.width = settings->get_width() + 2;
+		screen_params.start_x = std::max(0, (k_menu_width - view_width - 2)/2);
+		screen_params.height = view_height + 2;
+		screen_params.width = view_width + 2;
 
-		bottom_params.start_y = k_header_height + settings->get_height() + 2;
+		bottom_params.start_y = k_header_height + screen_params.height;
 		bottom_params.start_x = 0;
 		bottom_params.height = k_bottom_height;
 		bottom_params.width = k_menu_width;
+		view_dirty = true;
 	}
 
-	header = create_win(header_params.height,
-						header_params.width,
-						header_params.start_x,
-						header_params.start_y);
-	screen = create_win(screen_params.height,
-						screen_params.width,
-						screen_params.start_x,
-						screen_params.start_y);
-	bottom = create_win(bottom_params.height,
-						bottom_params.width,
-						bottom_params.start_x,
-						bottom_params.start_y);
+	// whatever the previous layout left outside the new windows is erased
+	werase(stdscr);
+	wnoutrefresh(stdscr);
+	place_win(header, header_params);
+	place_win(screen, screen_params);
+	place_win(bottom, bottom_params);
+	stats_valid = false;
 	print_header();
 }
 
+void IOLinux::handle_resize() {
+	clearok(curscr, TRUE);
+	layout_windows();
+
+	if(menu_screen) {
+		print_menu(last_menu_level);
+	} else if(last_field != NULL) {
+		if(last_revealed) {
+			print_revealed_board(last_field, last_won, last_c_x, last_c_y);
+		} else {
+			follow_cursor(last_c_x, last_c_y);
+			print_board(last_field, last_c_x, last_c_y, last_marked, last_percent);
+		}
+	}
+}
+
 void IOLinux::print_header() {
 	mvwprintw(header, 1, 24, "M I N E S W E E P E R");
     wrefresh(header);
 }
 
+// the windows are kept for the next screen, see init_IO
 void IOLinux::close_IO() {
-	destroy_win(header);
-	destroy_win(screen);
-	destroy_win(bottom);
-	endwin();
-	refresh();
 }
 
 void IOLinux::_debug(WINDOW* win, const char* msg, int x, int y) {
@@ -108,82 +187,113 @@ void IOLinux::_debug(WINDOW* win, const char* msg, int x, int y) {
 	wrefresh(win);
 }
 
-// sets a tile's color based on its content
-void IOLinux::set_tile_color(char ch, bool attr_on, int print_type) {
-	if (ch >= '1' && ch <= '8') {
-		set_color(screen, "Number", attr_on);
-		return;
-	}
-
-	switch(ch) {
-		case ' ': {
-			set_color(screen, "Undiscovered", attr_on);
-			break;
-		}
-		case '.': {
-			set_color(screen, "Empty", attr_on);
-			break;
-		}
-		case 'F': {
-			set_color(screen, "Flag", attr_on);
-			break;
-		}
-		case 'o': {
-			set_color(screen, "Highlight", attr_on);
-			break;
-		}
-		case '+': {
-			if(print_type == 1) {
-				set_color(screen, "Cursor_1", attr_on);
-			} else {
-				set_color(screen, "Cursor_2", attr_on);
-			}
-			break;
-		}
-		case 'x': {
-			if(print_type == 1) {
-				set_color(screen, "Highlight", attr_on);
-			} else {
-				set_color(screen, "Important", attr_on);
-			}
-			break;
-		}
-		default:
-			break;
-	}
+// looks up the symbol and attributes a tile is drawn with
+chtype IOLinux::tile_look(char ch, int print_type) {
+	return tile_looks[print_type][(unsigned char)ch];
 }
 
+// repaints only the visible tiles that differ from what the pad already
+// holds (the old and the new cursor positions included), each row is sent
+// with a single call covering its changed span, and redraws the status
+// line only when one of its counters changed
 void IOLinux::print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y, int marked, double percent) {
-	int height = settings->get_height() + 2;
-	int width = settings->get_width() + 2;
+	last_field = visible_field;
+	last_c_x = c_x;
+	last_c_y = c_y;
+	last_revealed = false;
 
-	for(int i = 1; i < height-1; i ++) {
-		for(int j = 1; j < width-1; j++) {
+	follow_cursor(c_x, c_y);
+
+	// only the slice of the board inside the viewport is drawn
+	int first_row = view_y + 1;
+	int first_col = view_x + 1;
+	int end_row = first_row + view_height;
+	int end_col = first_col + view_width;
+
+	for(int i = first_row; i < end_row; i ++) {
+		int first = -1;
+		int last = -1;
+
+		for(int j = first_col; j < end_col; j++) {
 			if(i != c_x || j != c_y) {
-				set_tile_color(visible_field[i][j], true, 0);
-				mvwaddch(screen, i, j, visible_field[i][j]);
-				set_tile_color(visible_field[i][j], false, 0);
+				row_buffer[j] = tile_look(visible_field[i][j], 0);
+			} else if(visible_field[i][j] == '.') {
+				row_buffer[j] = tile_look(k_cursor, 1);
 			} else {
-				if(visible_field[i][j] == '.') {
-					set_tile_color(k_cursor, true, 1);
-				} else {
-					set_tile_color(k_cursor, true, 0);
-				}
-
-				mvwaddch(screen, i, j, k_cursor);
+				row_buffer[j] = tile_look(k_cursor, 0);
+			}
 
-				if(visible_field[i][j] == '.') {
-					set_tile_color(k_cursor, false, 1);
-				} else {
-					set_tile_color(k_cursor, false, 0);
+			if(last_frame[i][j] != row_buffer[j]) {
+				last_frame[i][j] = row_buffer[j];
+				if(first < 0) {
+					first = j;
 				}
+				last = j;
 			}
 		}
+
+		if(first > 0) {
+			mvwaddchnstr(board_pad, i - 1, first - 1, row_buffer + first, last - first + 1);
+		}
 	}
 
-	wrefresh(screen);
+	refresh_view();
+
+	if(!stats_valid || marked != last_marked || percent != last_percent) {
+		print_stats(marked, settings->get_bombs(), percent);
+	}
+}
 
-	print_stats(marked, settings->get_bombs(), percent);
+// the viewport only moves when the cursor comes within a quarter of its size
+// from one of its edges, and it is then centered on the cursor, so most
+// cursor moves do not scroll the board
+void IOLinux::follow_cursor(int c_x, int c_y) {
+	int row = c_x - 1;
+	int col = c_y - 1;
+	int margin_y = view_height / 4;
+	int margin_x = view_width / 4;
+	int new_y = view_y;
+	int new_x = view_x;
+
+	if(row < view_y + margin_y || row >= view_y + view_height - margin_y) {
+		new_y = row - view_height / 2;
+	}
+	if(col < view_x + margin_x || col >= view_x + view_width - margin_x) {
+		new_x = col - view_width / 2;
+	}
+	new_y = std::max(0, std::min(new_y, settings->get_height() - view_height));
+	new_x = std::max(0, std::min(new_x, settings->get_width() - view_width));
+
+	if(new_y != view_y || new_x != view_x) {
+		view_y = new_y;
+		view_x = new_x;
+		view_dirty = true;
+	}
+}
+
+void IOLinux::refresh_view() {
+	if(view_dirty) {
+		// the pad's lines that were not changed would not be copied
+		touchwin(board_pad);
+		view_dirty = false;
+	}
+	prefresh(board_pad,
+				view_y,
+				view_x,
+				screen_params.start_y + 1,
+				screen_params.start_x + 1,
+				screen_params.start_y + view_height,
+				screen_params.start_x + view_width);
+}
+
+// marks every tile of the pad as unknown
+void IOLinux::invalidate_frame() {
+	for(int i = 0; i < MAT_HEIGHT; i ++) {
+		for(int j = 0; j < MAT_WIDTH; j ++) {
+			last_frame[i][j] = 0;
+		}
+	}
+	stats_valid = false;
 }
 
 void IOLinux::print_stats(int marked, int bombs, double percent) {
@@ -193,63 +303,77 @@ void IOLinux::print_stats(int marked, int bombs, double percent) {
 	mvwprintw(bottom, 1, line_start, k_print_clear);
 	mvwprintw(bottom, 1, line_start, "Marked ");
 	if(marked > bombs) {
-		set_color(bottom, "Important", true);
+		set_color(bottom, IMPORTANT, true);
 	} else {
-		set_color(bottom, "Highlight", true);
+		set_color(bottom, HIGHLIGHT, true);
 	}
 
 	offset += 7;
 	mvwprintw(bottom, 1, line_start + offset, "%d", marked);
 	if(marked > bombs) {
-		set_color(bottom, "Important", false);
+		set_color(bottom, IMPORTANT, false);
 	} else {
-		set_color(bottom, "Highlight", false);
+		set_color(bottom, HIGHLIGHT, false);
 	}
 
 	offset += get_nr_of_digits(marked) + 1;
 	mvwprintw(bottom, 1, line_start + offset, "of");
-	set_color(bottom, "Highlight", true);
+	set_color(bottom, HIGHLIGHT, true);
 	offset += 3;
 	mvwprintw(bottom, 1, line_start + offset, "%d", bombs);
-	set_color(bottom, "Highlight", false);
+	set_color(bottom, HIGHLIGHT, false);
 
 	offset += get_nr_of_digits(bombs);
 	mvwprintw(bottom, 1, line_start + offset, ". Solved ");
-	set_color(bottom, "Highlight", true);
+	set_color(bottom, HIGHLIGHT, true);
 	offset += 9;
 	mvwprintw(bottom, 1, line_start + offset, "%.1f%%", percent);
-	set_color(bottom, "Highlight", false);
+	set_color(bottom, HIGHLIGHT, false);
 	offset += get_nr_of_digits((int)percent) + 3;
 	mvwprintw(bottom, 1, line_start + offset, ".");
 	wrefresh(bottom);
+
+	last_marked = marked;
+	last_percent = percent;
+	stats_valid = true;
 }
 
 int IOLinux::get_nr_of_digits(int n) {
-	if(n < 10) return 1;
-	if(n < 100) return 2;
-	if(n < 1000) return 3;
-	return 4;
+	int digits = 1;
+	while(n >= 10) {
+		n /= 10;
+		digits ++;
+	}
+	return digits;
 }
 
-void IOLinux::print_revealed_board(char visible_field[][MAT_WIDTH], bool won) {
-	int height = settings->get_height() + 2;
-	int width = settings->get_width() + 2;
+void IOLinux::print_revealed_board(char visible_field[][MAT_WIDTH], bool won, int c_x, int c_y) {
 	int print_type;
 
+	last_field = visible_field;
+	last_c_x = c_x;
+	last_c_y = c_y;
+	last_revealed = true;
+	last_won = won;
+
+	follow_cursor(c_x, c_y);
+
 	if(won) {
 		print_type = 1;
 	} else {
 		print_type = 2;
 	}
 
-	for(int i = 1; i < height-1; i ++) {
-		for(int j = 1; j < width-1; j++) {
-			set_tile_color(visible_field[i][j], true, print_type);
-			mvwaddch(screen, i, j, visible_field[i][j]);
-			set_tile_color(visible_field[i][j], false, print_type);
+	int first_row = view_y + 1;
+	int first_col = view_x + 1;
+	for(int i = first_row; i < first_row + view_height; i ++) {
+		for(int j = first_col; j < first_col + view_width; j++) {
+			row_buffer[j] = tile_look(visible_field[i][j], print_type);
+			last_frame[i][j] = row_buffer[j];
 		}
+		mvwaddchnstr(board_pad, i - 1, view_x, row_buffer + first_col, view_width);
 	}
-	wrefresh(screen);
+	refresh_view();
 }
 
 void IOLinux::print_win_message() {
@@ -309,6 +433,7 @@ void IOLinux::print_lose_message() {
 }
 
 void IOLinux::print_menu(int menu_level) {
+	last_menu_level = menu_level;
 
 	for(int i = 1; i < k_menu_height - 1; i ++) {
 		mvwprintw(screen, i, 1, k_print_clear);
@@ -329,18 +454,12 @@ void IOLinux::print_menu(int menu_level) {
 		}
 		case 2: {
 			int row = 1;
-			std::stringstream ss;
 			for(auto it = rules.begin(); it != rules.end(); it ++) {
-					ss << *it;
-					mvwprintw(screen,
-								row,
-								1,
-								(ss.str()).c_str());
-					ss.str(std::string()); // clear contents
+					mvwprintw(screen, row, 1, "%s", it->c_str());
 					row ++;
 			}
 
-			mvwprintw(screen, 14, k_options_pos_x, "[1] Back");
+			mvwprintw(screen, row, k_options_pos_x, "[1] Back");
 			break;
 		}
 		case 3: {
@@ -349,7 +468,20 @@ void IOLinux::print_menu(int menu_level) {
 			mvwprintw(screen, 5, k_options_pos_x, "[3] Master");
 			mvwprintw(screen, 6, k_options_pos_x, "[4] Fullscreen Master");
 			mvwprintw(screen, 7, k_options_pos_x, "[5] Custom");
-			mvwprintw(screen, 9, k_options_pos_x, "[6] Back");
+			mvwprintw(screen, 9, k_options_pos_x, "[6] No-guess boards: %s",
+						!settings->get_no_guess() ? "off" :
+						settings->no_guess_possible() ? "on" :
+						"on (too dense)");
+			if(settings->get_min_3bv() == 0 && settings->get_max_3bv() == 0) {
+				mvwprintw(screen, 10, k_options_pos_x, "[7] 3BV range: any");
+			} else if(settings->get_max_3bv() == 0) {
+				mvwprintw(screen, 10, k_options_pos_x, "[7] 3BV range: %d and up",
+							settings->get_min_3bv());
+			} else {
+				mvwprintw(screen, 10, k_options_pos_x, "[7] 3BV range: %d to %d",
+							settings->get_min_3bv(), settings->get_max_3bv());
+			}
+			mvwprintw(screen, 12, k_options_pos_x, "[8] Back");
 
 			int info_y_loc = screen_params.height - 2;
 			int info_x_loc = 2;
@@ -372,15 +504,13 @@ void IOLinux::print_menu(int menu_level) {
 				default:
 					break;
 			}
-			std::stringstream ss;
-			ss << " difficulty - " << settings->get_height() << "x" 
-									<< settings->get_width() << ", "
-									<< settings->get_bombs() << " bombs)";
-
 			mvwprintw(screen,
 						info_y_loc,
 						info_x_loc + 7,
-						(ss.str()).c_str());
+						" difficulty - %dx%d, %d bombs)",
+						settings->get_height(),
+						settings->get_width(),
+						settings->get_bombs());
 			break;
 		}
 		default:
@@ -392,6 +522,9 @@ void IOLinux::print_menu(int menu_level) {
 
 void IOLinux::clear_bottom_input() {
     mvwprintw(bottom, 2, 1, k_print_clear);
+    if(!menu_screen) {
+        mvwprintw(bottom, 2, 1, "%s", estimate_line);
+    }
     move(bottom_params.start_y + 2, 2);
     wrefresh(bottom);
 }
@@ -400,13 +533,56 @@ char IOLinux::read_char() {
 
 	cbreak();
 	clear_bottom_input();
-	char c = getch();
+	int c = getch();
+	while(c == KEY_RESIZE) {
+		handle_resize();
+		clear_bottom_input();
+		c = getch();
+	}
 	nocbreak();
 	return c;
 }
 
-std::string IOLinux::read_string() {
-	std::string input;
+char IOLinux::poll_char() {
+	cbreak();
+	nodelay(stdscr, TRUE);
+	int c = getch();
+	nodelay(stdscr, FALSE);
+	nocbreak();
+
+	if(c == ERR) {
+		return 0;
+	}
+	if(c == KEY_RESIZE) {
+		handle_resize();
+		return 0;
+	}
+	return c;
+}
+
+char IOLinux::wait_char(int ms) {
+	cbreak();
+	timeout(ms);
+	int c = getch();
+	timeout(-1);
+	nocbreak();
+
+	if(c == ERR) {
+		return 0;
+	}
+	if(c == KEY_RESIZE) {
+		handle_resize();
+		return 0;
+	}
+	return c;
+}
+
+bool IOLinux::is_scripted() {
+	return false;
+}
+
+// reads a line into buf, without its new line, and returns its length
+int IOLinux::read_line(char* buf, int size) {
 	int chars = 0;
 
 	clear_bottom_input();
@@ -415,20 +591,33 @@ std::string IOLinux::read_string() {
 	echo();
     nocbreak();
     int c = getch();
-    chars ++;
 
-    while ( c != '\n'  && MAT_WIDTH - 3)
+    while (c != '\n')
     {
-        input.push_back(c);
+        if(c == KEY_RESIZE) {
+            handle_resize();
+            mvwaddch(bottom, 2, 1, k_prompt);
+            wrefresh(bottom);
+        } else if(chars < size - 1) {
+            buf[chars ++] = c;
+        }
         c = getch();
-        chars ++;
     }
+    buf[chars] = '\0';
 
-    return input;
+    return chars;
+}
+
+std::string IOLinux::read_string() {
+	char input[MAT_WIDTH];
+
+	read_line(input, MAT_WIDTH);
+	return std::string(input);
 }
 
 int IOLinux::read_int() {
-	std::string input;
+	char input[MAT_WIDTH];
+	char* end;
 	int ret;
 
 	clear_bottom_input();
@@ -436,24 +625,34 @@ int IOLinux::read_int() {
 	wrefresh(bottom);
 
 	while(true) {
-		input = read_string();
+		read_line(input, MAT_WIDTH);
 
-		std::stringstream inputStream(input);
-		if(inputStream >> ret) {
+		ret = strtol(input, &end, 10);
+		if(end != input) {
 			mvwprintw(bottom, 1, 1, k_print_clear);
+			stats_valid = false;
 			clear_bottom_input();
 			return ret;
 		}
 	}
 }
 
-void IOLinux::print_str(std::string message) {
+void IOLinux::print_str(const char* message) {
 	mvwprintw(bottom, 1, 1, k_print_clear);
-	mvwprintw(bottom, 1, 1, message.c_str());
+	mvwprintw(bottom, 1, 1, "%s", message);
+	wrefresh(bottom);
+	// the message shares its row with the statistics
+	stats_valid = false;
+}
+
+void IOLinux::print_estimate(const char* message) {
+	snprintf(estimate_line, sizeof(estimate_line), "%s", message);
+	mvwprintw(bottom, 2, 1, k_print_clear);
+	mvwprintw(bottom, 2, 1, "%s", estimate_line);
 	wrefresh(bottom);
 }
 
-void IOLinux::println_str(std::string message) {
+void IOLinux::println_str(const char* message) {
 	print_str(message);
 }
 
@@ -461,109 +660,82 @@ void IOLinux::println_str(std::string message) {
 void IOLinux::print_clear() {
 }
 
-void IOLinux::print_diff_constraints(std::string name, int min, int max, bool err) {
+void IOLinux::print_diff_constraints(const char* name, int min, int max, bool err) {
+	char message[MAT_WIDTH];
+
 	if(err) {
-		std::stringstream ss;
-		ss << "Bad input, the " << name << " must be between "
-			<< min << " and " << max << ".";
-		print_str((ss.str()).c_str());
+		snprintf(message, sizeof(message),
+					"Bad input, the %s must be between %d and %d.",
+					name, min, max);
 	} else {
-		name[0] = toupper(name[0]);
-		std::stringstream ss;
-		ss << name << " (between " << min << " and " << max << "):";
-		print_str((ss.str()).c_str());
+		snprintf(message, sizeof(message), "%c%s (between %d and %d):",
+					toupper(name[0]), name + 1, min, max);
 	}
+	print_str(message);
 }
 
 void IOLinux::init_colors() {
 	start_color();
-	init_pair(1, COLOR_YELLOW, COLOR_BLACK); // Highlight
-	attr_types["Highlight"] = 1;
-	init_pair(2, COLOR_BLACK, COLOR_BLACK); // Undiscovered tile
-	attr_types["Undiscovered"] = 2;
-	init_pair(3, COLOR_CYAN, COLOR_CYAN); // Empty tile
-	attr_types["Empty"] = 3;
-	init_pair(4, COLOR_GREEN, COLOR_BLACK); // Number tile
-	attr_types["Number"] = 4;
-	init_pair(5, COLOR_MAGENTA, COLOR_BLACK); // Flag
-	attr_types["Flag"] = 5;
-	init_pair(6, COLOR_RED, COLOR_CYAN); // Cursor_1
-	attr_types["Cursor_1"] = 6;
-	init_pair(7, COLOR_RED, COLOR_BLACK); // Cursor_2
-	attr_types["Cursor_2"] = 7;
-	init_pair(8, COLOR_RED, COLOR_BLACK); // Important info
-	attr_types["Important"] = 8;
-}
-
-void IOLinux::set_color(WINDOW* win, std::string type, bool attr_on) {
-
-	switch(attr_types[type]) {
-		case 1: { // Default
-			if(attr_on) {
-				wattrset(win, COLOR_PAIR(1) | A_BOLD);
-			} else {
-				wattroff(win, COLOR_PAIR(1) | A_BOLD);
-			}
-			break;
-		}
-		case 2: { // Undiscovered tile
-			if(attr_on) {
-				wattron(win, COLOR_PAIR(2));
-			} else {
-				wattroff(win, COLOR_PAIR(2));
-			}
-			break;
-		}
-		case 3: { // Empty tile
-			if(attr_on) {
-				wattron(win, COLOR_PAIR(3));
-			} else {
-				wattroff(win, COLOR_PAIR(3));
-			}
-			break;
-		}
-		case 4: { // Number tile
-			if(attr_on) {
-				wattron(win, COLOR_PAIR(4));
-			} else {
-				wattroff(win, COLOR_PAIR(4));
-			}
-			break;
-		}
-		case 5: { // Flag tile
-			if(attr_on) {
-				wattron(win, COLOR_PAIR(5) | A_BOLD);
-			} else {
-				wattroff(win, COLOR_PAIR(5) | A_BOLD);
-			}
-			break;
-		}
-		case 6: { // Cursor_1
-			if(attr_on) {
-				wattron(win, COLOR_PAIR(6) | A_BOLD);
-			} else {
-				wattroff(win, COLOR_PAIR(6) | A_BOLD);
-			}
-			break;
-		}
-		case 7: { // Cursor_2
-			if(attr_on) {
-				wattron(win, COLOR_PAIR(7) | A_BOLD);
-			} else {
-				wattroff(win, COLOR_PAIR(7) | A_BOLD);
-			}
-			break;
-		}
-		case 8: { // Important info
-			if(attr_on) {
-				wattron(win, COLOR_PAIR(8));
+	init_pair(HIGHLIGHT, COLOR_YELLOW, COLOR_BLACK);
+	init_pair(UNDISCOVERED, COLOR_BLACK, COLOR_BLACK);
+	init_pair(EMPTY, COLOR_CYAN, COLOR_CYAN);
+	init_pair(NUMBER, COLOR_GREEN, COLOR_BLACK);
+	init_pair(FLAG, COLOR_MAGENTA, COLOR_BLACK);
+	init_pair(CURSOR_1, COLOR_RED, COLOR_CYAN);
+	init_pair(CURSOR_2, COLOR_RED, COLOR_BLACK);
+	init_pair(IMPORTANT, COLOR_RED, COLOR_BLACK);
+
+	color_attrs[0] = A_NORMAL;
+	color_attrs[HIGHLIGHT] = COLOR_PAIR(HIGHLIGHT) | A_BOLD;
+	color_attrs[UNDISCOVERED] = COLOR_PAIR(UNDISCOVERED);
+	color_attrs[EMPTY] = COLOR_PAIR(EMPTY);
+	color_attrs[NUMBER] = COLOR_PAIR(NUMBER);
+	color_attrs[FLAG] = COLOR_PAIR(FLAG) | A_BOLD;
+	color_attrs[CURSOR_1] = COLOR_PAIR(CURSOR_1) | A_BOLD;
+	color_attrs[CURSOR_2] = COLOR_PAIR(CURSOR_2) | A_BOLD;
+	color_attrs[IMPORTANT] = COLOR_PAIR(IMPORTANT);
+
+	// print types: 0 - game in progress, 1 - game won, 2 - game lost
+	for(int print_type = 0; print_type < 3; print_type ++) {
+		for(int ch = 0; ch < 256; ch ++) {
+			int type = 0;
+
+			if(ch >= '1' && ch <= '8') {
+				type = NUMBER;
 			} else {
-				wattroff(win, COLOR_PAIR(8));
+				switch(ch) {
+					case EMPTYH:
+						type = UNDISCOVERED;
+						break;
+					case EMPTYD:
+						type = EMPTY;
+						break;
+					case FLAGT:
+						type = FLAG;
+						break;
+					case GOODFT:
+						type = HIGHLIGHT;
+						break;
+					case '+':
+						type = (print_type == 1) ? CURSOR_1 : CURSOR_2;
+						break;
+					case BOMBT:
+						type = (print_type == 1) ? HIGHLIGHT : IMPORTANT;
+						break;
+					default:
+						break;
+				}
 			}
-			break;
+			tile_looks[print_type][ch] = (chtype)ch | color_attrs[type];
 		}
-		default:
-			break;
+	}
+}
+
+void IOLinux::set_color(WINDOW* win, int type, bool attr_on) {
+	if(attr_on) {
+		wattron(win, color_attrs[type]);
+	} else {
+		wattroff(win, color_attrs[type]);
 	}
 }
 
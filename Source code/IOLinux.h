@@ -9,7 +9,7 @@
 #define _IOLINUX_H_
 
 #include <string>
-#include <map>
+#include <ncurses.h>
 #include "GameSettings.h"
 #include "Utils.h"
 #include "IOInterface.h"
@@ -22,6 +22,19 @@ struct win_params {
 	int width;
 };
 
+// color types used by the interface, their values are the color pairs
+enum color_type {
+	HIGHLIGHT = 1,
+	UNDISCOVERED,
+	EMPTY,
+	NUMBER,
+	FLAG,
+	CURSOR_1,
+	CURSOR_2,
+	IMPORTANT,
+	COLOR_TYPES
+};
+
 class IOLinux : public IOInterface {
 private:
 	GameSettings* settings;
@@ -32,8 +45,11 @@ private:
 	win_params screen_params;
 	WINDOW* bottom;
 	win_params bottom_params;
-	// a mapping of used to identify colors by strings
-	std::map<std::string, int> attr_types;
+	// attributes (color pair and boldness) of each color type
+	chtype color_attrs[COLOR_TYPES];
+	// final look of a tile (symbol | color pair | attributes), indexed by
+	// print type and the tile's symbol, filled once by init_colors
+	chtype tile_looks[3][256];
 	// used to clear rows
 	const char* k_print_clear;
 	const char* k_input_clear;
@@ -44,37 +60,86 @@ private:
 	const int k_options_pos_x;
 	const int k_prompt;
 	const char k_cursor;
+	// true once the ncurses session was started, it lasts until
+	// the object is destroyed
+	bool session_started;
+	// the whole game board is drawn on a pad, the screen window shows the
+	// part of it that fits the terminal (the viewport)
+	WINDOW* board_pad;
+	int view_y, view_x;
+	int view_height, view_width;
+	// true when the viewport moved or was covered and has to be copied
+	// to the terminal again
+	bool view_dirty;
+	// what is currently shown, used to redraw the scene after a resize
+	bool menu_screen;
+	int last_menu_level;
+	char (*last_field)[MAT_WIDTH];
+	int last_c_x, last_c_y;
+	bool last_revealed;
+	bool last_won;
+	// tiles currently drawn on the pad (0 if unknown), used to repaint only
+	// the changed tiles
+	chtype last_frame[MAT_HEIGHT][MAT_WIDTH];
+	// row being built before it is sent to the screen
+	chtype row_buffer[MAT_WIDTH];
+	// last counters shown by print_stats
+	int last_marked;
+	double last_percent;
+	bool stats_valid;
+	// shown under the statistics while playing, empty for none
+	char estimate_line[MAT_WIDTH];
 
 public:
 	IOLinux(GameSettings* settings);
+	~IOLinux();
 
 	char read_char();
+	char poll_char();
+	char wait_char(int ms);
+	bool is_scripted();
+	int read_line(char* buf, int size);
 	std::string read_string();
 	int read_int();
 	void print_clear();
 	void io_update_settings(GameSettings* settings);
 	void print_menu(int menu_level);
-	void print_str(std::string message);
-	void println_str(std::string message);
+	void print_str(const char* message);
+	// the input row is not used while playing, the estimate takes it
+	void print_estimate(const char* message);
+	void println_str(const char* message);
 	void print_header();
-	void print_diff_constraints(std::string name, int min, int max, bool err);
+	void print_diff_constraints(const char* name, int min, int max, bool err);
 	void print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y, int marked, double percent);
 	void print_win_message();
 	void print_lose_message();
-	void print_revealed_board(char visible_field[][MAT_WIDTH], bool won);
+	// the viewport follows (c_x, c_y), so the whole revealed board can be
+	// looked at by moving the cursor
+	void print_revealed_board(char visible_field[][MAT_WIDTH], bool won, int c_x, int c_y);
 	void init_IO(bool menu_type_scr);
 	void close_IO();
 	// clear bottom window's input space
 	void clear_bottom_input();
 	void init_colors();
-	void set_tile_color(char ch, bool attr_on, int print_type);
-	void set_color(WINDOW* win, std::string type, bool attr_on);
+	chtype tile_look(char ch, int print_type);
+	void set_color(WINDOW* win, int type, bool attr_on);
 	// debugging function, no use while running the game
 	void _debug(WINDOW* win, const char* msg, int x, int y);
 
-	WINDOW* create_win(int height, int width, int start_y, int start_x);
+	void place_win(WINDOW*& win, const win_params& params);
 	void destroy_win(WINDOW* win/*, win_params win_p*/);
 	void print_stats(int marked, int bombs, double percent);
+	// forces the next print_board call to repaint the whole board
+	void invalidate_frame();
+	// computes the windows' parameters from the terminal's size and
+	// creates them
+	void layout_windows();
+	// moves the viewport when the cursor gets close to its edges
+	void follow_cursor(int c_x, int c_y);
+	// copies the viewport's part of the pad to the terminal
+	void refresh_view();
+	// rebuilds the scene after the terminal was resized
+	void handle_resize();
 	// calculates the number of digits a number has
 	int get_nr_of_digits(int n);
 };
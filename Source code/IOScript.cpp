@@ -0,0 +1,168 @@
+/**
+	IOScript.cpp
+		Headless input/output interface for the game. Contains the
+	implementations of the functions defined in 'IOScript.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include "IOScript.h"
+
+IOScript::IOScript(GameSettings* settings) :
+	settings(settings),
+	script_pos(0),
+	last_question(0),
+	games_won(0),
+	games_lost(0),
+	last_percent(0.0)
+	{}
+
+bool IOScript::load_file(const char* path) {
+	std::ifstream file(path);
+	if(!file) {
+		return false;
+	}
+
+	std::stringstream contents;
+	contents << file.rdbuf();
+	load_string(contents.str());
+	return true;
+}
+
+void IOScript::load_string(const std::string& keys) {
+	script = keys;
+	script_pos = 0;
+	last_question = 0;
+}
+
+int IOScript::get_games_won() {
+	return games_won;
+}
+
+int IOScript::get_games_lost() {
+	return games_lost;
+}
+
+double IOScript::get_last_percent() {
+	return last_percent;
+}
+
+char IOScript::next_key() {
+	while(script_pos < script.size()) {
+		char key = script[script_pos ++];
+		if(key != '\n' && key != '\r') {
+			return key;
+		}
+	}
+	return 0;
+}
+
+char IOScript::read_char() {
+	char key = next_key();
+	if(key != 0) {
+		// the quit confirmation takes any key, play again only y/n
+		if(last_question == 1 || key == 'y' || key == 'n') {
+			last_question = 0;
+		}
+		return key;
+	}
+
+	switch(last_question) {
+		case 1:
+			last_question = 0;
+			return 'y';
+		case 2:
+			return 'n';
+		default:
+			return 'q';
+	}
+}
+
+char IOScript::poll_char() {
+	return next_key();
+}
+
+// no key comes while the game waits: the script goes on only once the
+// game is done waiting (see is_scripted), so the same script always
+// plays the same game
+char IOScript::wait_char(int ms) {
+	return 0;
+}
+
+bool IOScript::is_scripted() {
+	return true;
+}
+
+std::string IOScript::read_string() {
+	std::string input;
+	while(script_pos < script.size() && script[script_pos] != '\n') {
+		input.push_back(script[script_pos ++]);
+	}
+	if(script_pos < script.size()) {
+		script_pos ++;
+	}
+	return input;
+}
+
+int IOScript::read_int() {
+	std::string input = read_string();
+	return atoi(input.c_str());
+}
+
+// nothing is displayed by this interface
+void IOScript::print_clear() {
+}
+
+void IOScript::io_update_settings(GameSettings* settings) {
+	this->settings = settings;
+}
+
+void IOScript::print_menu(int menu_level) {
+}
+
+void IOScript::print_str(const char* message) {
+}
+
+void IOScript::print_estimate(const char* message) {
+}
+
+// the only line printed by the game is the quit confirmation
+void IOScript::println_str(const char* message) {
+	last_question = 1;
+}
+
+void IOScript::print_header() {
+}
+
+void IOScript::print_diff_constraints(const char* name, int min, int max, bool err) {
+}
+
+void IOScript::print_board(char visible_field[][MAT_WIDTH],
+							int c_x,
+							int c_y,
+							int marked,
+							double percent) {
+	last_percent = percent;
+}
+
+void IOScript::print_win_message() {
+	games_won ++;
+	last_question = 2;
+}
+
+void IOScript::print_lose_message() {
+	games_lost ++;
+	last_question = 2;
+}
+
+void IOScript::print_revealed_board(char visible_field[][MAT_WIDTH], bool won,
+										int c_x, int c_y) {
+}
+
+void IOScript::init_IO(bool menu_type_scr) {
+}
+
+void IOScript::close_IO() {
+}
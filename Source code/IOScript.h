@@ -0,0 +1,70 @@
+/**
+	IOScript.h
+		Headless input/output interface for the game. Nothing is displayed
+	and the keys are read from a script (a file or a string in memory),
+	so whole games can be played at memory speed, e.g. for simulations,
+	fuzzing or regression runs. Inherits IOInterface to ensure
+	compatibility with the game.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _IOSCRIPT_H_
+#define _IOSCRIPT_H_
+
+#include <string>
+#include "GameSettings.h"
+#include "Utils.h"
+#include "IOInterface.h"
+
+class IOScript : public IOInterface {
+private:
+	GameSettings* settings;
+	// the keys to play, new lines are ignored
+	std::string script;
+	size_t script_pos;
+	// last question asked by the game, answered once the script ends
+	// 0 - none, 1 - quit confirmation, 2 - play again
+	int last_question;
+	int games_won;
+	int games_lost;
+	double last_percent;
+
+	// next key of the script, 0 once it ended
+	char next_key();
+
+public:
+	IOScript(GameSettings* settings);
+
+	// returns false if the file could not be read
+	bool load_file(const char* path);
+	void load_string(const std::string& keys);
+	int get_games_won();
+	int get_games_lost();
+	// percentage of safe tiles discovered in the last board shown
+	double get_last_percent();
+
+	// once the script ended the game is quit: 'q' and 'y' while
+	// playing, 'n' when asked to play again
+	char read_char();
+	char poll_char();
+	char wait_char(int ms);
+	bool is_scripted();
+	std::string read_string();
+	int read_int();
+	void print_clear();
+	void io_update_settings(GameSettings* settings);
+	void print_menu(int menu_level);
+	void print_str(const char* message);
+	void print_estimate(const char* message);
+	void println_str(const char* message);
+	void print_header();
+	void print_diff_constraints(const char* name, int min, int max, bool err);
+	void print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y, int marked, double percent);
+	void print_win_message();
+	void print_lose_message();
+	void print_revealed_board(char visible_field[][MAT_WIDTH], bool won, int c_x, int c_y);
+	void init_IO(bool menu_type_scr);
+	void close_IO();
+};
+
+#endif // _IOSCRIPT_H_
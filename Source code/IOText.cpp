@@ -8,25 +8,83 @@
 */
 #include <iostream>
 #include <string>
-#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <unistd.h>
+#include <poll.h>
 #include "IOText.h"
 
-IOText::IOText(GameSettings* settings) {
-	this->settings = settings;
+#define ANSI_ALT_SCREEN_ON	"\x1b[?1049h"
+#define ANSI_ALT_SCREEN_OFF	"\x1b[?1049l"
+#define ANSI_CLEAR_SCREEN	"\x1b[H\x1b[2J"
+#define ANSI_CLEAR_LINE_END	"\x1b[K"
+#define ANSI_CLEAR_BELOW	"\x1b[J"
+
+IOText::IOText(GameSettings* settings, bool ansi_mode) :
+	settings(settings),
+	ansi_mode(ansi_mode),
+	alt_screen_on(false),
+	pending_pos(0),
+	stats_end(0)
+	{
+	// enough room for the largest board and its decorations
+	frame.reserve((MAT_HEIGHT + 8) * (MAT_WIDTH + 16));
+	output.reserve(frame.capacity() * 2);
+	last_frame.reserve(frame.capacity());
+	estimate_line.reserve(MAT_WIDTH);
+}
+
+IOText::~IOText() {
+	if(alt_screen_on) {
+		output = ANSI_ALT_SCREEN_OFF;
+		write_out(output);
+	}
 }
 
-// not necessary here
 void IOText::init_IO(bool menu_type_scr) {
+	if(ansi_mode && !alt_screen_on) {
+		output = ANSI_ALT_SCREEN_ON;
+		write_out(output);
+		alt_screen_on = true;
+	}
 }
 
 // not necessary here
 void IOText::close_IO() {
 }
 
+// reads a whole line and returns its first key, the rest of the line
+// is kept for poll_char
 char IOText::read_char() {
-	std::string input;
-	getline(std::cin, input);
-	return input[0];
+	getline(std::cin, pending_input);
+	pending_pos = 1;
+	return pending_input[0];
+}
+
+char IOText::poll_char() {
+	if(pending_pos < pending_input.size()) {
+		return pending_input[pending_pos ++];
+	}
+	return 0;
+}
+
+// the keys come a line at a time, a line is only read once it is there
+char IOText::wait_char(int ms) {
+	if(pending_pos < pending_input.size()) {
+		return pending_input[pending_pos ++];
+	}
+	if(std::cin.rdbuf()->in_avail() <= 0) {
+		struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+		if(poll(&input, 1, ms) <= 0) {
+			return 0;
+		}
+	}
+	return read_char();
+}
+
+bool IOText::is_scripted() {
+	return false;
 }
 
 std::string IOText::read_string() {
@@ -36,24 +94,49 @@ std::string IOText::read_string() {
 }
 
 int IOText::read_int() {
-	std::string input;
+	char* end;
 	int ret;
 
 	while(true) {
-		getline(std::cin, input);
+		// the line buffer is reused, its capacity is kept between reads
+		getline(std::cin, pending_input);
+		pending_pos = pending_input.size();
 
-		std::stringstream inputStream(input);
-		if(inputStream >> ret) {
+		ret = strtol(pending_input.c_str(), &end, 10);
+		if(end != pending_input.c_str()) {
 			return ret;
 		}
 		println_str("A number please!");
 	}
 }
 
-// 'clears the screen' by writing 23 new lines to stdout
+// 'clears the screen' by writing 23 new lines to stdout, or by
+// an escape sequence when running in ANSI mode
 void IOText::print_clear() {
-	for(int i = 0; i < 23; i ++) {
-		std::cout << std::endl;
+	if(ansi_mode) {
+		output = ANSI_CLEAR_SCREEN;
+		last_frame.clear();
+		stats_end = 0;
+	} else {
+		output.assign(23, '\n');
+	}
+	write_out(output);
+}
+
+// writes data to stdout with as few system calls as possible, after
+// flushing anything that was already queued on std::cout
+void IOText::write_out(const std::string& data) {
+	std::cout.flush();
+
+	const char* buf = data.data();
+	size_t left = data.size();
+	while(left > 0) {
+		ssize_t written = write(STDOUT_FILENO, buf, left);
+		if(written <= 0) {
+			break;
+		}
+		buf += written;
+		left -= written;
 	}
 }
 
@@ -102,7 +185,21 @@ void IOText::print_menu(int menu_level) {
 			std::cout << "\t[4] Fullscreen Master" << std::endl;
 			std::cout << "\t[5] Custom" << std::endl;
 			std::cout << std::endl; // space
-			std::cout << "\t[6] Back" << std::endl;
+			std::cout << "\t[6] No-guess boards: "
+						<< (!settings->get_no_guess() ? "off" :
+							settings->no_guess_possible() ? "on" :
+							"on (too dense)") << std::endl;
+			std::cout << "\t[7] 3BV range: ";
+			if(settings->get_min_3bv() == 0 && settings->get_max_3bv() == 0) {
+				std::cout << "any" << std::endl;
+			} else if(settings->get_max_3bv() == 0) {
+				std::cout << settings->get_min_3bv() << " and up" << std::endl;
+			} else {
+				std::cout << settings->get_min_3bv() << " to "
+							<< settings->get_max_3bv() << std::endl;
+			}
+			std::cout << std::endl; // space
+			std::cout << "\t[8] Back" << std::endl;
 			std::cout << std::endl; // space
 			std::cout << "(";
 				switch(settings->get_diff()) {
@@ -135,15 +232,27 @@ void IOText::print_menu(int menu_level) {
 	}
 }
 
-void IOText::print_str(std::string message) {
-	std::cout << message;
+void IOText::print_str(const char* message) {
+	std::cout << message << std::flush;
+}
+
+void IOText::print_estimate(const char* message) {
+	estimate_line.assign(message);
+	if(ansi_mode && stats_end > 0) {
+		frame.assign(last_frame, 0, stats_end);
+		if(!estimate_line.empty()) {
+			frame.append(estimate_line);
+			frame.push_back('\n');
+		}
+		flush_frame();
+	}
 }
 
-void IOText::println_str(std::string message) {
+void IOText::println_str(const char* message) {
 	std::cout << message << std::endl;
 }
 
-void IOText::print_diff_constraints(std::string name,
+void IOText::print_diff_constraints(const char* name,
 										int min,
 										int max,
 										bool err) {
@@ -152,8 +261,8 @@ void IOText::print_diff_constraints(std::string name,
 					<< min << " and " << max << ".";
 		std::cout << std::endl << "> ";
 	} else {
-		name[0] = toupper(name[0]);
-		std::cout << name << " (between " << min << " and " << max << "):";
+		std::cout << (char)toupper(name[0]) << name + 1
+					<< " (between " << min << " and " << max << "):";
 		std::cout << std::endl << "> ";
 	}
 }
@@ -162,45 +271,103 @@ void IOText::io_update_settings(GameSettings* settings) {
 	this->settings = settings;
 }
 
-void IOText::print_board(char visible_field[][MAT_WIDTH],
-							int c_x,
-							int c_y,
-							int marked,
-							double percent) {
+void IOText::build_board(char visible_field[][MAT_WIDTH], int c_x, int c_y) {
 	int height = settings->get_height() + 2;
 	int width = settings->get_width() + 2;
 
-	print_clear();
-	print_header();
+	frame.append(LINE01 LINE01 "\n");
+	frame.append(LINE02 "\n");
+	frame.append(LINE01 LINE01 "\n");
 	for(int i = 0; i < height; i ++) {
-		for(int j = 0; j < width; j++) {
-			this->visible_field[i][j] = visible_field[i][j];
-			if(i != c_x || j != c_y) {
-				std::cout << this->visible_field[i][j];
-			} else {
-				std::cout << '+';
-			}
+		frame.append(visible_field[i], width);
+		if(i == c_x) {
+			frame[frame.size() - width + c_y] = '+';
 		}
-		std::cout << std::endl;
+		frame.push_back('\n');
 	}
-
-	std::cout << std::endl;
-	std::cout << "Marked " << marked << " of " << settings->get_bombs()
-				<< " bombs. Solved " << (int)percent << "%%." << std::endl;
 }
 
-void IOText::print_revealed_board(char visible_field[][MAT_WIDTH], bool won) {
-	int height = settings->get_height() + 2;
-	int width = settings->get_width() + 2;
+// in the default mode the whole frame, including the new lines that clear
+// the screen, is sent at once; in ANSI mode only the lines that differ from
+// the last frame are rewritten, in place
+void IOText::flush_frame() {
+	if(!ansi_mode) {
+		output.assign(23, '\n');
+		output.append(frame);
+		write_out(output);
+		return;
+	}
 
-	print_clear();
-	print_header();
-	for(int i = 0; i < height; i ++) {
-		for(int j = 0; j < width; j++) {
-			std::cout << visible_field[i][j];
+	char position[16];
+	size_t pos = 0;
+	size_t last_pos = 0;
+	int line = 1;
+
+	output.clear();
+	if(last_frame.empty()) {
+		output.append(ANSI_CLEAR_SCREEN);
+	}
+	while(pos < frame.size()) {
+		size_t end = frame.find('\n', pos);
+		size_t last_end = std::string::npos;
+		if(last_pos < last_frame.size()) {
+			last_end = last_frame.find('\n', last_pos);
+		}
+
+		if(last_end == std::string::npos ||
+			last_end - last_pos != end - pos ||
+			last_frame.compare(last_pos, end - pos, frame, pos, end - pos)) {
+			snprintf(position, sizeof(position), "\x1b[%d;1H", line);
+			output.append(position);
+			output.append(frame, pos, end - pos);
+			output.append(ANSI_CLEAR_LINE_END);
+		}
+
+		pos = end + 1;
+		if(last_end != std::string::npos) {
+			last_pos = last_end + 1;
+		} else {
+			last_pos = last_frame.size();
 		}
-		std::cout << std::endl;
+		line ++;
 	}
+	// the input typed since the last frame is wiped out
+	snprintf(position, sizeof(position), "\x1b[%d;1H", line);
+	output.append(position);
+	output.append(ANSI_CLEAR_BELOW);
+
+	write_out(output);
+	last_frame.swap(frame);
+}
+
+void IOText::print_board(char visible_field[][MAT_WIDTH],
+							int c_x,
+							int c_y,
+							int marked,
+							double percent) {
+	char stats[96];
+
+	frame.clear();
+	build_board(visible_field, c_x, c_y);
+	snprintf(stats, sizeof(stats), "\nMarked %d of %d bombs. Solved %d%%.\n",
+				marked, settings->get_bombs(), (int)percent);
+	frame.append(stats);
+	size_t end = frame.size();
+	if(!estimate_line.empty()) {
+		frame.append(estimate_line);
+		frame.push_back('\n');
+	}
+	flush_frame();
+	stats_end = end;
+}
+
+// the whole board is printed, the cursor is not needed
+void IOText::print_revealed_board(char visible_field[][MAT_WIDTH], bool won,
+									int c_x, int c_y) {
+	frame.clear();
+	build_board(visible_field, -1, -1);
+	flush_frame();
+	stats_end = 0;
 }
 
 void IOText::print_win_message() {
@@ -17,27 +17,55 @@
 class IOText : public IOInterface {
 private:
 	GameSettings* settings;
-	char visible_field[MAT_HEIGHT][MAT_WIDTH];
+	// when true, frames are drawn on the alternate screen using ANSI escape
+	// sequences and only the lines that changed are rewritten
+	bool ansi_mode;
+	bool alt_screen_on;
+	// reusable buffers holding the frame being built, the lines sent to
+	// the terminal and the last frame drawn (used for line diffing)
+	std::string frame;
+	std::string output;
+	std::string last_frame;
+	// keys typed on the last line that was read but not used yet
+	std::string pending_input;
+	size_t pending_pos;
+	// shown under the statistics of the board, empty for none, and where
+	// the statistics end in the last frame (0 if it was not a board)
+	std::string estimate_line;
+	size_t stats_end;
+
+	// appends the header and the board (with the cursor, if any) to frame
+	void build_board(char visible_field[][MAT_WIDTH], int c_x, int c_y);
+	// sends the built frame to the terminal with a single write
+	void flush_frame();
+	void write_out(const std::string& data);
 
 public:
-	IOText(GameSettings* settings);
+	IOText(GameSettings* settings, bool ansi_mode = false);
+	~IOText();
 
 	char read_char();
+	char poll_char();
+	char wait_char(int ms);
+	bool is_scripted();
 	std::string read_string();
 	int read_int();
 	// clears the screen
 	void print_clear();
 	void io_update_settings(GameSettings* settings);
 	void print_menu(int menu_level);
-	void print_str(std::string message);
-	void println_str(std::string message);
+	void print_str(const char* message);
+	// in ANSI mode the last board is drawn again with it, otherwise it
+	// comes with the next one
+	void print_estimate(const char* message);
+	void println_str(const char* message);
 	void print_header();
 	// when choosing custom values for games difficulty
-	void print_diff_constraints(std::string name, int min, int max, bool err);
+	void print_diff_constraints(const char* name, int min, int max, bool err);
 	void print_board(char visible_field[][MAT_WIDTH], int c_x, int c_y, int marked, double percent);
 	void print_win_message();
 	void print_lose_message();
-	void print_revealed_board(char visible_field[][MAT_WIDTH], bool won);
+	void print_revealed_board(char visible_field[][MAT_WIDTH], bool won, int c_x, int c_y);
 	void init_IO(bool menu_type_scr);
 	void close_IO();
 };
@@ -0,0 +1,242 @@
+/**
+	LatencyBench.cpp
+		Measures the keystroke to screen latency of the ncurses interface.
+	The game is started under a pseudo-terminal, scripted keys are sent to
+	it and the time until its output settles is recorded for every key.
+	For each board preset it reports the p50/p99/max latency and the number
+	of bytes written per frame.
+
+	Usage: './latency_bench [-n KEYS] [-g PATH] [PRESET...]'
+
+	@author Sergiu Constantinescu
+*/
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <pty.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock bench_clock;
+
+// the output is considered settled after this much silence
+#define SETTLE_MS	30
+// silence allowed while the game starts or changes screens
+#define SCREEN_MS	200
+
+// shown on the status line of the game screen only
+#define GAME_SCREEN	"Marked "
+
+// keys played in a loop during the measurement
+const char* k_script = "dddsssaaawwwe e ddssd aawwe ";
+
+struct key_sample {
+	double latency_ms;
+	size_t bytes;
+};
+
+struct game_process {
+	pid_t pid;
+	int fd;
+};
+
+double ms_since(bench_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(
+				bench_clock::now() - start).count();
+}
+
+// reads everything the game writes until it stays silent for settle_ms;
+// returns the number of bytes read and stores the time of the last byte
+size_t drain(game_process& game, int settle_ms, std::string& seen,
+				bench_clock::time_point& last_byte) {
+	char buf[4096];
+	size_t total = 0;
+	struct pollfd pfd;
+
+	pfd.fd = game.fd;
+	pfd.events = POLLIN;
+	last_byte = bench_clock::now();
+	while(poll(&pfd, 1, settle_ms) > 0) {
+		ssize_t n = read(game.fd, buf, sizeof(buf));
+		if(n <= 0) {
+			break;
+		}
+		total += n;
+		seen.append(buf, n);
+		last_byte = bench_clock::now();
+	}
+	return total;
+}
+
+// sends keys one at a time, waiting for the screen each one draws, and
+// appends the output to seen
+void send_keys(game_process& game, const char* keys, std::string& seen) {
+	bench_clock::time_point last_byte;
+
+	for(const char* k = keys; *k; k ++) {
+		if(write(game.fd, k, 1) != 1) {
+			return;
+		}
+		drain(game, SCREEN_MS, seen, last_byte);
+	}
+}
+
+bool start_game(game_process& game, const char* path) {
+	struct winsize ws;
+	memset(&ws, 0, sizeof(ws));
+	ws.ws_row = 40;
+	ws.ws_col = 100;
+
+	game.pid = forkpty(&game.fd, NULL, NULL, &ws);
+	if(game.pid < 0) {
+		return false;
+	}
+	if(game.pid == 0) {
+		if(getenv("TERM") == NULL) {
+			setenv("TERM", "xterm", 1);
+		}
+		execl(path, path, (char*)NULL);
+		_exit(127);
+	}
+	return true;
+}
+
+void stop_game(game_process& game) {
+	std::string seen;
+	send_keys(game, "qy3", seen);
+	close(game.fd);
+	kill(game.pid, SIGTERM);
+	waitpid(game.pid, NULL, 0);
+}
+
+double percentile(std::vector<double>& values, double p) {
+	if(values.empty()) {
+		return 0.0;
+	}
+	size_t i = (size_t)(p * (values.size() - 1) + 0.5);
+	return values[i];
+}
+
+// plays the script on the given preset and prints its statistics
+bool bench_preset(const char* path, int preset, int nr_of_keys) {
+	game_process game;
+	std::vector<key_sample> samples;
+	const char* names[] = {"custom", "novice", "adept", "master", "fullscreen"};
+
+	if(!start_game(game, path)) {
+		std::cerr << "Could not start " << path << std::endl;
+		return false;
+	}
+
+	// options -> difficulty -> preset -> back -> back -> new game
+	char menu[] = {'2', '2', (char)('0' + preset), '8', '3', '1', '\0'};
+	{
+		std::string seen;
+		bench_clock::time_point last_byte;
+		drain(game, SCREEN_MS, seen, last_byte);
+		send_keys(game, menu, seen);
+		// the menus changed and the keys no longer lead to a game
+		if(seen.find(GAME_SCREEN) == std::string::npos) {
+			std::cerr << "The menu keys did not start a game" << std::endl;
+			stop_game(game);
+			return false;
+		}
+	}
+
+	size_t script_len = strlen(k_script);
+	for(int k = 0; k < nr_of_keys; k ++) {
+		std::string seen;
+		bench_clock::time_point last_byte;
+		char key = k_script[k % script_len];
+
+		bench_clock::time_point start = bench_clock::now();
+		if(write(game.fd, &key, 1) != 1) {
+			break;
+		}
+		size_t bytes = drain(game, SETTLE_MS, seen, last_byte);
+
+		key_sample sample;
+		sample.latency_ms = std::chrono::duration<double, std::milli>(
+								last_byte - start).count();
+		sample.bytes = bytes;
+		samples.push_back(sample);
+
+		// a finished game waits for a key, then asks to play again
+		if(seen.find("Baaam") != std::string::npos ||
+			seen.find("You won") != std::string::npos) {
+			std::string ignored;
+			send_keys(game, " y", ignored);
+		}
+	}
+	stop_game(game);
+
+	std::vector<double> latencies;
+	size_t bytes = 0;
+	for(size_t i = 0; i < samples.size(); i ++) {
+		latencies.push_back(samples[i].latency_ms);
+		bytes += samples[i].bytes;
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	char line[160];
+	snprintf(line, sizeof(line),
+				"%-10s keys %5zu  p50 %7.3f ms  p99 %7.3f ms  max %7.3f ms"
+				"  %7.1f bytes/frame",
+				names[preset],
+				samples.size(),
+				percentile(latencies, 0.50),
+				percentile(latencies, 0.99),
+				latencies.empty() ? 0.0 : latencies.back(),
+				samples.empty() ? 0.0 : (double)bytes / samples.size());
+	std::cout << line << std::endl;
+	return true;
+}
+
+void usage() {
+	std::cout << "Usage: './latency_bench [-n KEYS] [-g PATH] [PRESET...]'"
+				<< std::endl;
+	std::cout << "\tKEYS   - keys sent per preset (default 200)" << std::endl;
+	std::cout << "\tPATH   - game executable (default ./Minesweeper)"
+				<< std::endl;
+	std::cout << "\tPRESET - 1 novice, 2 adept, 3 master, 4 fullscreen"
+				<< " (default all)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	int nr_of_keys = 200;
+	const char* path = "./Minesweeper";
+	std::vector<int> presets;
+
+	for(int i = 1; i < argc; i ++) {
+		std::string arg(argv[i]);
+		if(arg == "-n" && i + 1 < argc) {
+			nr_of_keys = atoi(argv[++ i]);
+		} else if(arg == "-g" && i + 1 < argc) {
+			path = argv[++ i];
+		} else if(arg.size() == 1 && arg[0] >= '1' && arg[0] <= '4') {
+			presets.push_back(arg[0] - '0');
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if(presets.empty()) {
+		for(int p = 1; p <= 4; p ++) {
+			presets.push_back(p);
+		}
+	}
+
+	for(size_t i = 0; i < presets.size(); i ++) {
+		if(!bench_preset(path, presets[i], nr_of_keys)) {
+			return 1;
+		}
+	}
+	return 0;
+}
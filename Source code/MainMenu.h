@@ -8,18 +8,22 @@
 #define _MAINMENU_H_
 
 #include "GameSettings.h"
+#include "BoardGenerator.h"
 
 
 template <class IO>
 class MainMenu {
 private:
 	IO* io_mode;
+	// rates random boards, to offer only 3BV ranges boards can have
+	BoardGenerator sampler;
 
 public:
 	MainMenu(IO* io_mod);
 	
 	int menu_loop(GameSettings *settings);
 	void choose_difficulty(GameSettings *settings);
+	void choose_3bv_range(GameSettings *settings);
 };
 
 #include "MainMenu.hpp"
@@ -7,13 +7,15 @@
 #ifndef __MAINMENU_HPP_
 #define __MAINMENU_HPP_
 
+#include <algorithm>
 #include <iostream>
 #include "GameSettings.h"
 #include "Utils.h"
 
 
 template <class IO>
-MainMenu<IO>::MainMenu(IO* io_mod){
+MainMenu<IO>::MainMenu(IO* io_mod) :
+	sampler(1) {
 	io_mode = io_mod;
 };
 
@@ -29,6 +31,8 @@ MainMenu<IO>::MainMenu(IO* io_mod){
 //			Master
 //			Master (fullscreen)
 //			Custom
+//			No-guess boards (on/off)
+//			3BV range
 //			Back
 //		Back
 // Exit
@@ -80,7 +84,11 @@ int MainMenu<IO>::menu_loop(GameSettings *settings) {
 				} else if(input == '5') { // custom
 					choose_difficulty(settings);
 					settings->set_diff(0);
-				} else if(input == '6') { // back
+				} else if(input == '6') { // no-guess boards on/off
+					settings->set_no_guess(!settings->get_no_guess());
+				} else if(input == '7') { // 3BV range
+					choose_3bv_range(settings);
+				} else if(input == '8') { // back
 					menu_level = 1;
 				}
 				break;
@@ -132,8 +140,8 @@ void MainMenu<IO>::choose_difficulty(GameSettings *settings) {
 		}
 	}
 
-	// 75% is the maximum amount of bomb tiles
-	int max_possible_bombs = (height * width) * 0.75;
+	// the first reveal needs a 3x3 block without bombs
+	int max_possible_bombs = GameSettings::max_bombs(height, width);
 
 	io_mode->print_diff_constraints("number of bombs", 
 									MIN_BOMBS,
@@ -154,4 +162,40 @@ void MainMenu<IO>::choose_difficulty(GameSettings *settings) {
 	settings->set_custom_diff(height, width, bombs);
 }
 
+// asks for the lowest and the highest 3BV of the boards, within the 3BV
+// of a sample of random boards of this size: far out of it, boards are
+// too rare to be found in time
+template <class IO>
+void MainMenu<IO>::choose_3bv_range(GameSettings *settings) {
+	int low, high;
+	sampler.sample_3bv(settings->get_height(), settings->get_width(),
+						settings->get_bombs(), 1, low, high);
+	int min_3bv = 0;
+	int max_3bv = 0;
+
+	io_mode->print_diff_constraints("lowest 3BV", low, high, false);
+	while(true) {
+		min_3bv = io_mode->read_int();
+		if(min_3bv < low || min_3bv > high) {
+			io_mode->print_diff_constraints("lowest 3BV", low, high, true);
+		} else {
+			break;
+		}
+	}
+
+	io_mode->print_diff_constraints("highest 3BV", min_3bv, high, false);
+	while(true) {
+		max_3bv = io_mode->read_int();
+		if(max_3bv < min_3bv || max_3bv > high) {
+			io_mode->print_diff_constraints("highest 3BV", min_3bv, high, true);
+		} else {
+			break;
+		}
+	}
+
+	// the ends of the sample mean no limit
+	settings->set_3bv_range(min_3bv == low ? 0 : min_3bv,
+							max_3bv == high ? 0 : max_3bv);
+}
+
 #endif // __MAINMENU_HPP_
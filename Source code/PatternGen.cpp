@@ -0,0 +1,73 @@
+/**
+	PatternGen.cpp
+		Writes the table of local patterns ('PatternTable.inc') to the
+	standard output; run by make before the solver is built. For every set
+	of unknown tiles of the window, all its layouts of mines are counted
+	against the three numbers, and every key that has at least one layout
+	gets the tiles that are never a mine and the tiles that always are.
+
+	@author Sergiu Constantinescu
+*/
+#include <cstdio>
+#include <vector>
+#include "Patterns.h"
+
+
+int main() {
+	// neighbours[k]: window tiles around the k-th number
+	int neighbours[3] = {0, 0, 0};
+	for(int k = 0; k < 3; k ++) {
+		for(int r = 0; r < 3; r ++) {
+			for(int c = k; c <= k + 2; c ++) {
+				int bit = pattern_bit(r, c);
+				if(bit >= 0) {
+					neighbours[k] |= 1 << bit;
+				}
+			}
+		}
+	}
+
+	std::vector<uint32_t> table(PATTERN_KEYS, 0);
+	std::vector<int> always(64);
+	std::vector<int> ever(64);
+	std::vector<char> found(64);
+	for(int unknown = 0; unknown < (1 << PATTERN_CELLS); unknown ++) {
+		for(int m = 0; m < 64; m ++) {
+			always[m] = unknown;
+			ever[m] = 0;
+			found[m] = 0;
+		}
+
+		// every subset of the unknown tiles
+		int mines = unknown;
+		while(true) {
+			int m0 = __builtin_popcount(mines & neighbours[0]);
+			int m1 = __builtin_popcount(mines & neighbours[1]);
+			int m2 = __builtin_popcount(mines & neighbours[2]);
+			if(m0 <= PATTERN_MAX_MINES && m1 <= PATTERN_MAX_MINES &&
+				m2 <= PATTERN_MAX_MINES) {
+				int m = m0 | (m1 << 2) | (m2 << 4);
+				always[m] &= mines;
+				ever[m] |= mines;
+				found[m] = 1;
+			}
+			if(mines == 0) {
+				break;
+			}
+			mines = (mines - 1) & unknown;
+		}
+
+		for(int m = 0; m < 64; m ++) {
+			if(found[m]) {
+				table[pattern_key(unknown, m & 3, (m >> 2) & 3, m >> 4)] =
+					(unknown & ~ever[m]) | (always[m] << PATTERN_MINES_SHIFT);
+			}
+		}
+	}
+
+	printf("// generated by PatternGen.cpp, do not edit\n");
+	for(int key = 0; key < PATTERN_KEYS; key ++) {
+		printf("0x%x,%c", table[key], key % 8 == 7 ? '\n' : ' ');
+	}
+	return 0;
+}
@@ -0,0 +1,49 @@
+/**
+	Patterns.h
+		Layout of the local patterns shared by the table generator
+	('PatternGen.cpp') and the solver. A pattern is three revealed tiles
+	in a row, seen through the 3x5 window around them (the tiles of a
+	column for vertical rows, which reuse the table by transposing the
+	window). The 12 tiles of the window that are not the numbers are the
+	bits of the window mask, and the key packs the unknown tiles with the
+	mines each number still misses, up to PATTERN_MAX_MINES. The table maps
+	every key to the tiles that are safe or mines in all the layouts agreeing
+	with the three numbers, which covers the 1-2-1 and 1-2-2-1 rows, the
+	corners and the two number rules.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _PATTERNS_H_
+#define _PATTERNS_H_
+
+#include <stdint.h>
+
+#define PATTERN_CELLS		12
+#define PATTERN_MAX_MINES	3
+#define PATTERN_KEYS		(1 << (PATTERN_CELLS + 6))
+// a table entry holds the safe tiles in its low half, the mines in its high half
+#define PATTERN_MINES_SHIFT	16
+
+// window bit of the tile at row r (0..2) and column c (0..4) of the
+// window, -1 for the three numbers in the middle
+inline int pattern_bit(int r, int c) {
+	if(r == 0) {
+		return c;
+	}
+	if(r == 2) {
+		return 7 + c;
+	}
+	if(c == 0) {
+		return 5;
+	}
+	return c == 4 ? 6 : -1;
+}
+
+// unknown is a window mask, m0..m2 the mines missing around the numbers
+// from left to right
+inline int pattern_key(int unknown, int m0, int m1, int m2) {
+	return unknown | (m0 << PATTERN_CELLS) | (m1 << (PATTERN_CELLS + 2))
+			| (m2 << (PATTERN_CELLS + 4));
+}
+
+#endif // _PATTERNS_H_
@@ -0,0 +1,514 @@
+/**
+	Probability.cpp
+		Contains the implementation of the functions declared in
+	'Probability.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "Probability.h"
+
+
+ProbabilityEngine::ProbabilityEngine() :
+	height(0),
+	width(0),
+	probability(MAT_HEIGHT * MAT_WIDTH, -1.0),
+	tile_var(MAT_HEIGHT * MAT_WIDTH, -1),
+	interior_tiles(0),
+	interior_probability(0.0),
+	mines_left(0),
+	nodes(0),
+	node_limit(20000000),
+	cancel(NULL),
+	time_limit_ms(0),
+	sampling(false),
+	reservoir_state(0)
+	{}
+
+void ProbabilityEngine::set_node_limit(long limit) {
+	node_limit = limit;
+}
+
+void ProbabilityEngine::set_cancel(const std::atomic<bool>* flag) {
+	cancel = flag;
+}
+
+void ProbabilityEngine::set_time_limit(int ms) {
+	time_limit_ms = ms;
+}
+
+void ProbabilityEngine::set_sampling(bool on) {
+	sampling = on;
+}
+
+Solver& ProbabilityEngine::get_solver() {
+	return solver;
+}
+
+bool ProbabilityEngine::compute(char visible_field[][MAT_WIDTH], int height, int width, int bombs) {
+	this->height = height;
+	this->width = width;
+	deadline = std::chrono::steady_clock::now() +
+				std::chrono::milliseconds(time_limit_ms);
+
+	solver.load(visible_field, height, width);
+	solver.solve();
+	collect(visible_field, bombs);
+	split_components();
+
+	nodes = 0;
+	var_value.assign(var_tiles.size(), -1);
+	placed.assign(constraints.size(), 0);
+	unassigned.resize(constraints.size());
+	for(size_t c = 0; c < constraints.size(); c ++) {
+		unassigned[c] = constraints[c].vars.size();
+	}
+	for(size_t c = 0; c < components.size(); c ++) {
+		component& comp = components[c];
+		comp.counts.assign(comp.vars.size() + 1, 0.0);
+		comp.var_counts.assign(comp.vars.size() + 1,
+						std::vector<long double>(comp.vars.size(), 0.0));
+		comp.words = (comp.vars.size() + 63) / 64;
+		comp.layouts.assign(sampling ? comp.vars.size() + 1 : 0,
+							std::vector<uint64_t>());
+		if(!enumerate(comp, 0, 0)) {
+			return false;
+		}
+	}
+
+	return combine();
+}
+
+// sorts the hidden tiles into proven ones, unknown frontier tiles
+// (the variables) and interior tiles, and builds the constraints
+void ProbabilityEngine::collect(char visible_field[][MAT_WIDTH], int bombs) {
+	var_tiles.clear();
+	constraints.clear();
+	proven_mines.clear();
+	interior.clear();
+	mines_left = bombs;
+
+	// the borders too, an older and larger board may have left tiles there
+	for(int i = 0; i <= height + 1; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			tile_var[i * MAT_WIDTH + j] = -1;
+			probability[i * MAT_WIDTH + j] = -1.0;
+		}
+	}
+
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			int t = i * MAT_WIDTH + j;
+			char ch = visible_field[i][j];
+
+			if(ch != EMPTYH && ch != FLAGT) {
+				continue;
+			}
+			if(solver.is_mine(i, j)) {
+				probability[t] = 1.0;
+				proven_mines.push_back(t);
+				mines_left --;
+				continue;
+			}
+			if(solver.is_safe(i, j)) {
+				probability[t] = 0.0;
+				continue;
+			}
+
+			bool next_to_number = false;
+			for(int dx = -1; dx <= 1; dx ++) {
+				for(int dy = -1; dy <= 1; dy ++) {
+					char n = visible_field[i + dx][j + dy];
+					if(n >= '1' && n <= '8') {
+						next_to_number = true;
+					}
+				}
+			}
+			if(next_to_number) {
+				tile_var[t] = var_tiles.size();
+				var_tiles.push_back(t);
+			} else {
+				interior.push_back(t);
+			}
+		}
+	}
+
+	interior_tiles = interior.size();
+	var_constraints.assign(var_tiles.size(), std::vector<int>());
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			char ch = visible_field[i][j];
+			if(ch < '1' || ch > '8') {
+				continue;
+			}
+
+			constraint c;
+			c.mines = ch - '0';
+			for(int dx = -1; dx <= 1; dx ++) {
+				for(int dy = -1; dy <= 1; dy ++) {
+					int t = (i + dx) * MAT_WIDTH + j + dy;
+					if(tile_var[t] >= 0) {
+						c.vars.push_back(tile_var[t]);
+					} else if(probability[t] == 1.0) {
+						c.mines --;
+					}
+				}
+			}
+			if(!c.vars.empty()) {
+				for(size_t v = 0; v < c.vars.size(); v ++) {
+					var_constraints[c.vars[v]].push_back(constraints.size());
+				}
+				constraints.push_back(c);
+			}
+		}
+	}
+}
+
+// walks the variables through shared constraints; the variables of a
+// component end up in breadth first order, which makes the constraints
+// complete early and the pruning effective
+void ProbabilityEngine::split_components() {
+	std::vector<char> seen_var(var_tiles.size(), 0);
+	std::vector<char> seen_constraint(constraints.size(), 0);
+
+	components.clear();
+	for(size_t start = 0; start < var_tiles.size(); start ++) {
+		if(seen_var[start]) {
+			continue;
+		}
+
+		component comp;
+		seen_var[start] = 1;
+		comp.vars.push_back(start);
+		for(size_t k = 0; k < comp.vars.size(); k ++) {
+			const std::vector<int>& cs = var_constraints[comp.vars[k]];
+			for(size_t c = 0; c < cs.size(); c ++) {
+				if(seen_constraint[cs[c]]) {
+					continue;
+				}
+				seen_constraint[cs[c]] = 1;
+				comp.constraints.push_back(cs[c]);
+
+				const std::vector<int>& vs = constraints[cs[c]].vars;
+				for(size_t v = 0; v < vs.size(); v ++) {
+					if(!seen_var[vs[v]]) {
+						seen_var[vs[v]] = 1;
+						comp.vars.push_back(vs[v]);
+					}
+				}
+			}
+		}
+		components.push_back(comp);
+	}
+}
+
+bool ProbabilityEngine::assign(component& comp, int var, char value) {
+	bool ok = true;
+	const std::vector<int>& cs = var_constraints[var];
+
+	var_value[var] = value;
+	for(size_t k = 0; k < cs.size(); k ++) {
+		int c = cs[k];
+		placed[c] += value;
+		unassigned[c] --;
+		if(placed[c] > constraints[c].mines ||
+			placed[c] + unassigned[c] < constraints[c].mines) {
+			ok = false;
+		}
+	}
+	return ok;
+}
+
+void ProbabilityEngine::unassign(int var, char value) {
+	const std::vector<int>& cs = var_constraints[var];
+
+	var_value[var] = -1;
+	for(size_t k = 0; k < cs.size(); k ++) {
+		placed[cs[k]] -= value;
+		unassigned[cs[k]] ++;
+	}
+}
+
+// counts the layouts of the component's variables from pos on
+bool ProbabilityEngine::enumerate(component& comp, size_t pos, int mines) {
+	if(++ nodes > node_limit) {
+		return false;
+	}
+	// the clock and the flag are only looked at now and then
+	if(nodes % 4096 == 0) {
+		if(cancel != NULL && *cancel) {
+			return false;
+		}
+		if(time_limit_ms > 0 && std::chrono::steady_clock::now() > deadline) {
+			return false;
+		}
+	}
+
+	if(pos == comp.vars.size()) {
+		comp.counts[mines] += 1.0;
+		std::vector<long double>& row = comp.var_counts[mines];
+		for(size_t v = 0; v < comp.vars.size(); v ++) {
+			if(var_value[comp.vars[v]] == 1) {
+				row[v] += 1.0;
+			}
+		}
+		if(sampling) {
+			keep_layout(comp, mines);
+		}
+		return true;
+	}
+
+	int var = comp.vars[pos];
+	for(char value = 0; value <= 1; value ++) {
+		if(mines + value > mines_left) {
+			break;
+		}
+		bool ok = assign(comp, var, value);
+		if(ok && !enumerate(comp, pos + 1, mines + value)) {
+			unassign(var, value);
+			return false;
+		}
+		unassign(var, value);
+	}
+	return true;
+}
+
+// the layout just counted replaces a random kept one with probability
+// SAMPLE_RESERVOIR / (layouts seen), so the kept ones stay a uniform pick
+void ProbabilityEngine::keep_layout(component& comp, int mines) {
+	std::vector<uint64_t>& kept = comp.layouts[mines];
+	size_t slot = kept.size() / comp.words;
+
+	if(slot >= SAMPLE_RESERVOIR) {
+		uint64_t seen = (uint64_t)comp.counts[mines];
+		slot = splitmix64(reservoir_state ++) % seen;
+		if(slot >= SAMPLE_RESERVOIR) {
+			return;
+		}
+	} else {
+		kept.resize(kept.size() + comp.words);
+	}
+
+	uint64_t* bits = &kept[slot * comp.words];
+	for(int w = 0; w < comp.words; w ++) {
+		bits[w] = 0;
+	}
+	for(size_t v = 0; v < comp.vars.size(); v ++) {
+		if(var_value[comp.vars[v]] == 1) {
+			bits[v / 64] |= 1ULL << (v % 64);
+		}
+	}
+}
+
+// multiplies two mine count distributions
+static std::vector<long double> convolve(const std::vector<long double>& a,
+										const std::vector<long double>& b) {
+	std::vector<long double> result(a.size() + b.size() - 1, 0.0);
+	for(size_t i = 0; i < a.size(); i ++) {
+		if(a[i] == 0.0) {
+			continue;
+		}
+		for(size_t j = 0; j < b.size(); j ++) {
+			result[i + j] += a[i] * b[j];
+		}
+	}
+	return result;
+}
+
+bool ProbabilityEngine::combine() {
+	size_t nr_of_components = components.size();
+
+	// prefix[c] combines the components before c, suffix[c] the ones from
+	// c on (kept for sampling)
+	std::vector<std::vector<long double> > prefix(nr_of_components + 1);
+	suffix.assign(nr_of_components + 1, std::vector<long double>());
+	prefix[0] = std::vector<long double>(1, 1.0);
+	suffix[nr_of_components] = std::vector<long double>(1, 1.0);
+	for(size_t c = 0; c < nr_of_components; c ++) {
+		prefix[c + 1] = convolve(prefix[c], components[c].counts);
+	}
+	for(size_t c = nr_of_components; c > 0; c --) {
+		suffix[c - 1] = convolve(components[c - 1].counts, suffix[c]);
+	}
+	const std::vector<long double>& total = prefix[nr_of_components];
+
+	// weight[m]: ways to place the other mines_left - m mines in the
+	// interior tiles, relative to the largest one
+	std::vector<long double> weight(total.size(), 0.0);
+	std::vector<double> log_weight(total.size(), 0.0);
+	double max_log = -INFINITY;
+	for(size_t m = 0; m < total.size(); m ++) {
+		int rest = mines_left - (int)m;
+		if(rest < 0 || rest > interior_tiles) {
+			log_weight[m] = -INFINITY;
+			continue;
+		}
+		log_weight[m] = lgamma(interior_tiles + 1.0) - lgamma(rest + 1.0)
+						- lgamma(interior_tiles - rest + 1.0);
+		max_log = std::max(max_log, log_weight[m]);
+	}
+	if(max_log == -INFINITY) {
+		return false;
+	}
+	for(size_t m = 0; m < total.size(); m ++) {
+		if(log_weight[m] != -INFINITY) {
+			weight[m] = expl((long double)(log_weight[m] - max_log));
+		}
+	}
+
+	long double sum = 0.0;
+	long double interior_mines = 0.0;
+	for(size_t m = 0; m < total.size(); m ++) {
+		sum += total[m] * weight[m];
+		interior_mines += total[m] * weight[m] * (mines_left - (int)m);
+	}
+	if(sum <= 0.0) {
+		return false;
+	}
+	frontier_weight.resize(total.size());
+	for(size_t m = 0; m < total.size(); m ++) {
+		frontier_weight[m] = total[m] * weight[m];
+	}
+	interior_probability = 0.0;
+	if(interior_tiles > 0) {
+		interior_probability = interior_mines / sum / interior_tiles;
+	}
+
+	for(size_t c = 0; c < nr_of_components; c ++) {
+		component& comp = components[c];
+		std::vector<long double> others = convolve(prefix[c], suffix[c + 1]);
+
+		for(size_t v = 0; v < comp.vars.size(); v ++) {
+			long double mine = 0.0;
+			for(size_t k = 0; k < comp.counts.size(); k ++) {
+				if(comp.var_counts[k][v] == 0.0) {
+					continue;
+				}
+				long double rest = 0.0;
+				for(size_t o = 0; o < others.size(); o ++) {
+					rest += others[o] * weight[k + o];
+				}
+				mine += comp.var_counts[k][v] * rest;
+			}
+			probability[var_tiles[comp.vars[v]]] = mine / sum;
+		}
+	}
+
+	for(size_t t = 0; t < interior.size(); t ++) {
+		probability[interior[t]] = interior_probability;
+	}
+	return true;
+}
+
+double ProbabilityEngine::get_probability(int x, int y) {
+	return probability[x * MAT_WIDTH + y];
+}
+
+double ProbabilityEngine::get_interior_probability() {
+	return interior_probability;
+}
+
+bool ProbabilityEngine::safest(int& x, int& y) {
+	int best = -1;
+	double best_probability = 2.0;
+	int best_distance = 0;
+
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			double p = get_probability(i, j);
+			if(p < 0.0) {
+				continue;
+			}
+			int distance = std::max(std::abs(i - x), std::abs(j - y));
+			if(p < best_probability - 1e-12 ||
+				(p < best_probability + 1e-12 && distance < best_distance)) {
+				best = i * MAT_WIDTH + j;
+				best_probability = p;
+				best_distance = distance;
+			}
+		}
+	}
+
+	if(best < 0) {
+		return false;
+	}
+	x = best / MAT_WIDTH;
+	y = best % MAT_WIDTH;
+	return true;
+}
+
+size_t ProbabilityEngine::draw(const std::vector<long double>& weights,
+								uint64_t& state) {
+	long double sum = 0.0;
+	for(size_t k = 0; k < weights.size(); k ++) {
+		sum += weights[k];
+	}
+	// 53 random bits, as a double in [0, 1)
+	long double pick = (splitmix64(state ++) >> 11) / 9007199254740992.0L * sum;
+	size_t last = 0;
+	for(size_t k = 0; k < weights.size(); k ++) {
+		if(weights[k] <= 0.0) {
+			continue;
+		}
+		last = k;
+		if(pick < weights[k]) {
+			return k;
+		}
+		pick -= weights[k];
+	}
+	return last;
+}
+
+// the mines on the frontier first, then how they are split between the
+// components, a kept layout of every component and the rest of the
+// mines spread over the interior tiles
+void ProbabilityEngine::sample(uint64_t& state, char hidden[][MAT_WIDTH]) const {
+	for(int i = 0; i <= height + 1; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			bool wall = i == 0 || j == 0 || i == height + 1 || j == width + 1;
+			hidden[i][j] = wall ? WALL : EMPTYH;
+		}
+	}
+	for(size_t k = 0; k < proven_mines.size(); k ++) {
+		hidden[proven_mines[k] / MAT_WIDTH][proven_mines[k] % MAT_WIDTH] = BOMBT;
+	}
+
+	int frontier_mines = draw(frontier_weight, state);
+	int rest = frontier_mines;
+	std::vector<long double> weights;
+	for(size_t c = 0; c < components.size(); c ++) {
+		const component& comp = components[c];
+		const std::vector<long double>& after = suffix[c + 1];
+
+		weights.assign(comp.counts.size(), 0.0);
+		for(size_t k = 0; k < comp.counts.size() && (int)k <= rest; k ++) {
+			if(rest - k < after.size()) {
+				weights[k] = comp.counts[k] * after[rest - k];
+			}
+		}
+		int mines = draw(weights, state);
+		rest -= mines;
+
+		const std::vector<uint64_t>& kept = comp.layouts[mines];
+		size_t pick = splitmix64(state ++) % (kept.size() / comp.words);
+		const uint64_t* bits = &kept[pick * comp.words];
+		for(size_t v = 0; v < comp.vars.size(); v ++) {
+			if(bits[v / 64] & (1ULL << (v % 64))) {
+				int t = var_tiles[comp.vars[v]];
+				hidden[t / MAT_WIDTH][t % MAT_WIDTH] = BOMBT;
+			}
+		}
+	}
+
+	// every interior tile is picked with the chance left of being one
+	int needed = mines_left - frontier_mines;
+	int remaining = interior.size();
+	for(size_t k = 0; k < interior.size() && needed > 0; k ++, remaining --) {
+		if((int)(splitmix64(state ++) % remaining) < needed) {
+			hidden[interior[k] / MAT_WIDTH][interior[k] % MAT_WIDTH] = BOMBT;
+			needed --;
+		}
+	}
+}
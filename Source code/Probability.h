@@ -0,0 +1,129 @@
+/**
+	Probability.h
+		Computes the exact probability of being a mine for every hidden
+	tile, from what the player can see and the total number of bombs.
+	The tiles proven by the deterministic solver are fixed first. The other
+	hidden tiles next to revealed numbers are split into independent
+	components (tiles sharing no number), and the mine layouts of every
+	component that agree with its numbers are enumerated by backtracking.
+	The components are then combined with the remaining hidden tiles, far
+	from any number, weighting each total of mines on the frontier by the
+	ways of placing the rest of the bombs in those tiles (binomials are
+	handled in log space). The probability of a tile far from the numbers
+	follows in closed form.
+	With sampling on, a reservoir of the layouts of every component is
+	kept by number of mines, and whole boards can be drawn that agree with
+	the field, each with its true probability under the total of bombs.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _PROBABILITY_H_
+#define _PROBABILITY_H_
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "Solver.h"
+#include "Utils.h"
+
+// layouts of a component kept for every number of mines when sampling;
+// past that many, a uniform reservoir of them
+#define SAMPLE_RESERVOIR	4096
+
+
+class ProbabilityEngine {
+private:
+	// a revealed number and its unknown neighbours
+	struct constraint {
+		std::vector<int> vars;
+		int mines;
+	};
+	// unknown tiles linked by numbers, and their layouts counted
+	// by number of mines
+	struct component {
+		std::vector<int> vars;
+		std::vector<int> constraints;
+		// layouts with k mines
+		std::vector<long double> counts;
+		// layouts with k mines in which vars[v] is a mine, [k][v]
+		std::vector<std::vector<long double> > var_counts;
+		// sampled layouts with k mines, words bits each (bit v for vars[v])
+		std::vector<std::vector<uint64_t> > layouts;
+		int words;
+	};
+
+	int height;
+	int width;
+	Solver solver;
+	// probability of every tile (x * MAT_WIDTH + y), -1 if revealed
+	std::vector<double> probability;
+	// unknown frontier tiles, the constraints and the components
+	std::vector<int> var_tiles;
+	std::vector<int> tile_var;
+	std::vector<std::vector<int> > var_constraints;
+	std::vector<constraint> constraints;
+	std::vector<component> components;
+	// tiles proven mines by the solver
+	std::vector<int> proven_mines;
+	// hidden tiles not touching any number, and their probability
+	std::vector<int> interior;
+	int interior_tiles;
+	double interior_probability;
+	// mines not yet proven by the solver
+	int mines_left;
+	// enumeration state
+	std::vector<char> var_value;
+	std::vector<int> placed;
+	std::vector<int> unassigned;
+	long nodes;
+	long node_limit;
+	// set by another thread to stop the enumeration, and its time limit
+	const std::atomic<bool>* cancel;
+	int time_limit_ms;
+	std::chrono::steady_clock::time_point deadline;
+	// sampling: the reservoirs' random state, the layouts of the
+	// components after c by mines, [c][m], and the weight of m mines
+	// on the whole frontier
+	bool sampling;
+	uint64_t reservoir_state;
+	std::vector<std::vector<long double> > suffix;
+	std::vector<long double> frontier_weight;
+
+	void collect(char visible_field[][MAT_WIDTH], int bombs);
+	void split_components();
+	bool enumerate(component& comp, size_t pos, int mines);
+	bool assign(component& comp, int var, char value);
+	void unassign(int var, char value);
+	void keep_layout(component& comp, int mines);
+	// index drawn with probabilities proportional to weights
+	static size_t draw(const std::vector<long double>& weights, uint64_t& state);
+	bool combine();
+
+public:
+	ProbabilityEngine();
+
+	// computes the probabilities; returns false if the visible field is
+	// inconsistent, or the enumeration went over its limits or was cancelled
+	bool compute(char visible_field[][MAT_WIDTH], int height, int width, int bombs);
+	// probability that the hidden tile (x, y) is a mine
+	double get_probability(int x, int y);
+	double get_interior_probability();
+	// the hidden tile least likely to be a mine, the closest to (x, y)
+	// among equals; false if there is no hidden tile
+	bool safest(int& x, int& y);
+	// enumeration steps allowed for a single compute call
+	void set_node_limit(long limit);
+	// compute gives up once the flag is set or after ms milliseconds
+	// (0 for no limit)
+	void set_cancel(const std::atomic<bool>* flag);
+	void set_time_limit(int ms);
+	// keeps the layouts that sample draws from (off by default)
+	void set_sampling(bool on);
+	// writes a whole board agreeing with the field of the last successful
+	// compute to hidden (BOMBT, EMPTYH and WALL for the borders), drawn
+	// with state; safe to call from several threads at once
+	void sample(uint64_t& state, char hidden[][MAT_WIDTH]) const;
+	Solver& get_solver();
+};
+
+#endif // _PROBABILITY_H_
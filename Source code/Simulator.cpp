@@ -0,0 +1,345 @@
+/**
+	Simulator.cpp
+		Plays a large number of independent games headless, on all cores,
+	and reports statistics about them. Every game is generated from its own
+	seed, derived from the base seed and the game's index, so a run can be
+	repeated exactly no matter how many threads are used.
+
+	Usage: './minesweeper-sim [-n GAMES] [-t THREADS] [-s SEED] [-d DIFF]'
+	   or: './minesweeper-sim -l BOARDS [-t THREADS] [-s SEED]', which
+	reports how long no-guess boards take to generate, for every preset,
+	   or: './minesweeper-sim -r BOARDS [-t THREADS] [-s SEED]', which
+	rates random boards of every preset and reports their 3BV.
+
+	@author Sergiu Constantinescu
+*/
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include "GameState.h"
+#include "GameSettings.h"
+#include "IOScript.h"
+#include "WorkStealingPool.h"
+#include "BoardGenerator.h"
+#include "BoardRater.h"
+#include "Utils.h"
+
+// no-guess generation should stay under this, 99 times in 100
+#define LATENCY_TARGET_MS	100.0
+
+// statistics gathered by every thread, merged at the end
+struct sim_stats {
+	uint64_t games;
+	uint64_t wins;
+	uint64_t clicks;
+	double percent_solved;
+
+	sim_stats() : games(0), wins(0), clicks(0), percent_solved(0.0) {}
+
+	void merge(const sim_stats& other) {
+		games += other.games;
+		wins += other.wins;
+		clicks += other.clicks;
+		percent_solved += other.percent_solved;
+	}
+};
+
+// the game objects owned by one thread
+struct sim_worker {
+	GameSettings settings;
+	IOScript io_script;
+	GameState<IOScript> game_state;
+	// hidden tiles of the current board
+	std::vector<int> candidates;
+
+	sim_worker() : io_script(&settings), game_state(&io_script) {}
+};
+
+// reveals random hidden tiles until the game ends
+void play_random(GameState<IOScript>& game, std::mt19937_64& rng,
+					std::vector<int>& candidates, sim_stats& stats) {
+	char (*field)[MAT_WIDTH] = game.get_visible_field();
+
+	while(!game.is_won() && !game.is_lost()) {
+		candidates.clear();
+		for(int i = 1; i <= game.get_height(); i ++) {
+			for(int j = 1; j <= game.get_width(); j ++) {
+				if(field[i][j] == EMPTYH) {
+					candidates.push_back(i * MAT_WIDTH + j);
+				}
+			}
+		}
+
+		int tile = candidates[rng() % candidates.size()];
+		game.click(tile / MAT_WIDTH, tile % MAT_WIDTH);
+		stats.clicks ++;
+	}
+}
+
+// generates no-guess boards for every preset, from random first
+// tiles, and prints the distribution of the time each one took
+void report_latency(uint64_t nr_of_boards, int nr_of_threads, uint64_t base_seed) {
+	static char field[MAT_HEIGHT][MAT_WIDTH];
+	const char* names[] = {"", "Novice", "Adept", "Master", "Fullscreen"};
+	BoardGenerator generator(nr_of_threads);
+	GameSettings settings;
+	char line[128];
+
+	std::cout << "No-guess generation, " << nr_of_boards << " boards per preset,"
+				<< " target p99 < " << LATENCY_TARGET_MS << " ms" << std::endl;
+	std::cout << "Preset      Size    Failed  Attempts  Mean ms   p50 ms"
+				<< "   p99 ms   Max ms" << std::endl;
+	for(int diff = 1; diff <= 4; diff ++) {
+		settings.set_diff(diff);
+		int height = settings.get_height();
+		int width = settings.get_width();
+		std::vector<double> times;
+		uint64_t failed = 0;
+		uint64_t attempts = 0;
+
+		for(uint64_t board = 0; board < nr_of_boards; board ++) {
+			uint64_t seed = splitmix64(base_seed + board);
+			int x = 1 + seed % height;
+			int y = 1 + (seed >> 32) % width;
+
+			auto start = std::chrono::steady_clock::now();
+			if(!generator.generate(field, height, width, settings.get_bombs(),
+									x, y, seed, true)) {
+				failed ++;
+			}
+			times.push_back(std::chrono::duration<double, std::milli>(
+								std::chrono::steady_clock::now() - start).count());
+			attempts += generator.get_attempts();
+		}
+
+		std::sort(times.begin(), times.end());
+		double sum = 0.0;
+		for(size_t k = 0; k < times.size(); k ++) {
+			sum += times[k];
+		}
+		size_t p50 = times.size() / 2;
+		size_t p99 = std::min(times.size() - 1, times.size() * 99 / 100);
+		snprintf(line, sizeof(line),
+					"%-10s %3dx%-3d %7llu %9.1f %8.2f %8.2f %8.2f %8.2f%s",
+					names[diff], height, width, (unsigned long long)failed,
+					(double)attempts / nr_of_boards, sum / times.size(),
+					times[p50], times[p99], times.back(),
+					times[p99] > LATENCY_TARGET_MS ? "  over target" : "");
+		std::cout << line << std::endl;
+	}
+}
+
+// the objects owned by one thread while rating boards
+struct rate_worker {
+	BoardGenerator generator;
+	BoardRater rater;
+	char field[MAT_HEIGHT][MAT_WIDTH];
+	// boards by 3BV
+	std::vector<uint64_t> histogram;
+	uint64_t openings;
+	uint64_t isolated;
+
+	rate_worker() : generator(1), histogram(MAT_HEIGHT * MAT_WIDTH, 0),
+					openings(0), isolated(0) {}
+};
+
+// rates random boards of every preset, from random first tiles, on all
+// cores and prints the distribution of their 3BV and how many boards
+// were made and rated every second
+void report_3bv(uint64_t nr_of_boards, int nr_of_threads, uint64_t base_seed) {
+	const char* names[] = {"", "Novice", "Adept", "Master", "Fullscreen"};
+	WorkStealingPool pool(nr_of_threads);
+	GameSettings settings;
+	char line[128];
+
+	std::cout << "3BV of " << nr_of_boards << " random boards per preset ("
+				<< pool.get_threads() << " threads)" << std::endl;
+	std::cout << "Preset      Size    Min    p50  Mean    Max  Openings"
+				<< "  Isolated  Boards/s" << std::endl;
+	for(int diff = 1; diff <= 4; diff ++) {
+		settings.set_diff(diff);
+		int height = settings.get_height();
+		int width = settings.get_width();
+		int bombs = settings.get_bombs();
+		std::vector<rate_worker*> workers;
+		for(int w = 0; w < pool.get_threads(); w ++) {
+			workers.push_back(new rate_worker());
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		pool.parallel_for(nr_of_boards, 256, [&](int w, size_t board) {
+			rate_worker& worker = *workers[w];
+			uint64_t seed = splitmix64(base_seed + board);
+			int x = 1 + seed % height;
+			int y = 1 + (seed >> 32) % width;
+			worker.generator.generate(worker.field, height, width, bombs,
+										x, y, seed, false);
+			board_rating rating = worker.rater.rate(worker.field, height, width);
+			worker.histogram[rating.bbbv] ++;
+			worker.openings += rating.openings;
+			worker.isolated += rating.isolated;
+		});
+		double elapsed = std::chrono::duration<double>(
+							std::chrono::steady_clock::now() - start).count();
+
+		std::vector<uint64_t> histogram(MAT_HEIGHT * MAT_WIDTH, 0);
+		uint64_t openings = 0;
+		uint64_t isolated = 0;
+		for(size_t w = 0; w < workers.size(); w ++) {
+			for(size_t k = 0; k < histogram.size(); k ++) {
+				histogram[k] += workers[w]->histogram[k];
+			}
+			openings += workers[w]->openings;
+			isolated += workers[w]->isolated;
+			delete workers[w];
+		}
+
+		int min = -1;
+		int max = 0;
+		int p50 = 0;
+		uint64_t seen = 0;
+		double sum = 0.0;
+		for(size_t k = 0; k < histogram.size(); k ++) {
+			if(histogram[k] == 0) {
+				continue;
+			}
+			if(min < 0) {
+				min = k;
+			}
+			max = k;
+			if(seen < nr_of_boards / 2 + 1 && seen + histogram[k] >= nr_of_boards / 2 + 1) {
+				p50 = k;
+			}
+			seen += histogram[k];
+			sum += (double)k * histogram[k];
+		}
+		snprintf(line, sizeof(line),
+					"%-10s %3dx%-3d %5d %6d %5.1f %6d %9.1f %9.1f %9.0f",
+					names[diff], height, width, min, p50, sum / nr_of_boards,
+					max, (double)openings / nr_of_boards,
+					(double)isolated / nr_of_boards,
+					nr_of_boards / elapsed);
+		std::cout << line << std::endl;
+	}
+}
+
+void usage() {
+	std::cout << "Usage: './minesweeper-sim [-n GAMES] [-t THREADS]"
+				<< " [-s SEED] [-d DIFF]'" << std::endl;
+	std::cout << "   or: './minesweeper-sim -l BOARDS [-t THREADS] [-s SEED]'"
+				<< std::endl;
+	std::cout << "   or: './minesweeper-sim -r BOARDS [-t THREADS] [-s SEED]'"
+				<< std::endl;
+	std::cout << "\tGAMES   - games to play (default 100000)" << std::endl;
+	std::cout << "\tTHREADS - threads to use (default one per core)"
+				<< std::endl;
+	std::cout << "\tSEED    - base seed of the boards (default 1)"
+				<< std::endl;
+	std::cout << "\tDIFF    - 1 novice ... 4 fullscreen master (default 1)"
+				<< std::endl;
+	std::cout << "\tBOARDS  - boards to generate (-l no-guess, -r rated)"
+				<< " per preset" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	uint64_t nr_of_games = 100000;
+	int nr_of_threads = 0;
+	uint64_t base_seed = 1;
+	int diff = 1;
+	uint64_t latency_boards = 0;
+	uint64_t rated_boards = 0;
+
+	for(int i = 1; i < argc; i ++) {
+		std::string arg(argv[i]);
+		if(i + 1 >= argc) {
+			usage();
+			return 1;
+		}
+		if(arg == "-n") {
+			nr_of_games = strtoull(argv[++ i], NULL, 10);
+		} else if(arg == "-t") {
+			nr_of_threads = atoi(argv[++ i]);
+		} else if(arg == "-s") {
+			base_seed = strtoull(argv[++ i], NULL, 10);
+		} else if(arg == "-d") {
+			diff = atoi(argv[++ i]);
+		} else if(arg == "-l") {
+			latency_boards = strtoull(argv[++ i], NULL, 10);
+		} else if(arg == "-r") {
+			rated_boards = strtoull(argv[++ i], NULL, 10);
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if(nr_of_games == 0) {
+		usage();
+		return 1;
+	}
+
+	if(latency_boards > 0) {
+		report_latency(latency_boards, nr_of_threads, base_seed);
+		return 0;
+	}
+	if(rated_boards > 0) {
+		report_3bv(rated_boards, nr_of_threads, base_seed);
+		return 0;
+	}
+
+	WorkStealingPool pool(nr_of_threads);
+	std::vector<sim_worker*> workers;
+	std::vector<per_thread<sim_stats> > stats(pool.get_threads());
+	for(int w = 0; w < pool.get_threads(); w ++) {
+		workers.push_back(new sim_worker());
+		workers[w]->settings.set_diff(diff);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	pool.parallel_for(nr_of_games, 64, [&](int w, size_t game) {
+		sim_worker& worker = *workers[w];
+		uint64_t seed = splitmix64(base_seed + game);
+
+		// a zero seed would mean 'use the time'
+		worker.settings.set_seed(seed | 1);
+		worker.game_state.start_game(&worker.settings);
+
+		std::mt19937_64 rng(seed);
+		play_random(worker.game_state, rng, worker.candidates, stats[w].value);
+
+		stats[w].value.games ++;
+		if(worker.game_state.is_won()) {
+			stats[w].value.wins ++;
+		}
+		stats[w].value.percent_solved += worker.game_state.get_percent_solved();
+	});
+	double elapsed = std::chrono::duration<double>(
+						std::chrono::steady_clock::now() - start).count();
+
+	sim_stats total;
+	for(size_t w = 0; w < stats.size(); w ++) {
+		total.merge(stats[w].value);
+		delete workers[w];
+	}
+
+	char line[128];
+	std::cout << "Games:        " << total.games << " ("
+				<< pool.get_threads() << " threads)" << std::endl;
+	snprintf(line, sizeof(line), "Win rate:     %.4f%%",
+				100.0 * total.wins / total.games);
+	std::cout << line << std::endl;
+	snprintf(line, sizeof(line), "Clicks/game:  %.2f",
+				(double)total.clicks / total.games);
+	std::cout << line << std::endl;
+	snprintf(line, sizeof(line), "Solved/game:  %.2f%%",
+				total.percent_solved / total.games);
+	std::cout << line << std::endl;
+	snprintf(line, sizeof(line), "Time:         %.3f s (%.0f games/s)",
+				elapsed, total.games / elapsed);
+	std::cout << line << std::endl;
+	return 0;
+}
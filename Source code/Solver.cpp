@@ -0,0 +1,400 @@
+/**
+	Solver.cpp
+		Contains the implementation of the functions declared in
+	'Solver.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <cstdlib>
+#include <algorithm>
+#include "Solver.h"
+
+// generated by PatternGen.cpp, see Patterns.h
+static const uint32_t pattern_table[PATTERN_KEYS] = {
+#include "PatternTable.inc"
+};
+
+int8_t Solver::window_bit[2][3][9];
+int8_t Solver::window_tile[PATTERN_CELLS];
+
+Solver::Solver() :
+	height(0),
+	width(0),
+	field(NULL),
+	pair_rules(true),
+	safe_bits((MAT_HEIGHT * MAT_WIDTH + 63) / 64, 0),
+	mine_bits((MAT_HEIGHT * MAT_WIDTH + 63) / 64, 0),
+	constraints(MAT_HEIGHT * MAT_WIDTH),
+	queued(MAT_HEIGHT * MAT_WIDTH, 0)
+	{
+	for(int k = 0; k < 3; k ++) {
+		for(int dx = -1; dx <= 1; dx ++) {
+			for(int dy = -1; dy <= 1; dy ++) {
+				int bit = (dx + 1) * 3 + (dy + 1);
+				window_bit[0][k][bit] = pattern_bit(1 + dx, k + 1 + dy);
+				window_bit[1][k][bit] = pattern_bit(1 + dy, k + 1 + dx);
+			}
+		}
+	}
+	for(int r = 0; r < 3; r ++) {
+		for(int c = 0; c < 5; c ++) {
+			if(pattern_bit(r, c) >= 0) {
+				window_tile[pattern_bit(r, c)] = r * 5 + c;
+			}
+		}
+	}
+}
+
+uint64_t Solver::spread(uint16_t mask, int x, int y) {
+	uint64_t rows = (uint64_t)(mask & 7)
+					| ((uint64_t)((mask >> 3) & 7) << 7)
+					| ((uint64_t)((mask >> 6) & 7) << 14);
+	return rows << ((x - 1) * 7 + (y - 1));
+}
+
+// flagged tiles count as hidden
+bool Solver::is_hidden(int x, int y) {
+	return field[x][y] == EMPTYH || field[x][y] == FLAGT;
+}
+
+void Solver::load(char visible_field[][MAT_WIDTH], int height, int width) {
+	this->height = height;
+	this->width = width;
+	field = visible_field;
+
+	// closest_safe forgets tiles from the list, the bits are cleared whole
+	std::fill(safe_bits.begin(), safe_bits.end(), 0);
+	std::fill(mine_bits.begin(), mine_bits.end(), 0);
+	safe_tiles.clear();
+	mine_tiles.clear();
+	work_list.clear();
+
+	// the borders are read too, they clear what an older board left there
+	for(int i = 0; i <= height + 1; i ++) {
+		for(int j = 0; j <= width + 1; j ++) {
+			queued[index(i, j)] = 0;
+			build_constraint(i, j);
+			if(constraints[index(i, j)].active) {
+				push(index(i, j));
+			}
+		}
+	}
+}
+
+void Solver::attach(char visible_field[][MAT_WIDTH]) {
+	field = visible_field;
+}
+
+void Solver::build_constraint(int x, int y) {
+	constraint& c = constraints[index(x, y)];
+	char ch = field[x][y];
+
+	c.active = false;
+	if(ch < '1' || ch > '8') {
+		return;
+	}
+
+	c.unknown = 0;
+	c.mines = ch - '0';
+	for(int dx = -1; dx <= 1; dx ++) {
+		for(int dy = -1; dy <= 1; dy ++) {
+			int n = index(x + dx, y + dy);
+			if(!is_hidden(x + dx, y + dy)) {
+				continue;
+			}
+			if(test(mine_bits, n)) {
+				c.mines --;
+			} else if(!test(safe_bits, n)) {
+				c.unknown |= 1 << ((dx + 1) * 3 + (dy + 1));
+			}
+		}
+	}
+	c.active = c.unknown != 0;
+}
+
+void Solver::push(int i) {
+	if(!queued[i]) {
+		queued[i] = 1;
+		work_list.push_back(i);
+	}
+}
+
+// the new number is read, the numbers around only lose an unknown tile
+void Solver::update(int x, int y) {
+	build_constraint(x, y);
+	if(constraints[index(x, y)].active) {
+		push(index(x, y));
+	}
+
+	for(int dx = -1; dx <= 1; dx ++) {
+		for(int dy = -1; dy <= 1; dy ++) {
+			constraint& c = constraints[index(x + dx, y + dy)];
+			uint16_t bit = 1 << ((1 - dx) * 3 + (1 - dy));
+			if((dx != 0 || dy != 0) && c.active && (c.unknown & bit)) {
+				c.unknown &= ~bit;
+				c.active = c.unknown != 0;
+				push(index(x + dx, y + dy));
+			}
+		}
+	}
+}
+
+// a tile became known: the numbers around it lose an unknown neighbour
+void Solver::mark_safe(int i) {
+	if(test(safe_bits, i) || test(mine_bits, i)) {
+		return;
+	}
+	set(safe_bits, i);
+	safe_tiles.push_back(i);
+
+	int x = i / MAT_WIDTH;
+	int y = i % MAT_WIDTH;
+	for(int dx = -1; dx <= 1; dx ++) {
+		for(int dy = -1; dy <= 1; dy ++) {
+			constraint& c = constraints[index(x + dx, y + dy)];
+			if(c.active) {
+				c.unknown &= ~(1 << ((1 - dx) * 3 + (1 - dy)));
+				c.active = c.unknown != 0;
+				push(index(x + dx, y + dy));
+			}
+		}
+	}
+}
+
+void Solver::mark_mine(int i) {
+	if(test(safe_bits, i) || test(mine_bits, i)) {
+		return;
+	}
+	set(mine_bits, i);
+	mine_tiles.push_back(i);
+
+	int x = i / MAT_WIDTH;
+	int y = i % MAT_WIDTH;
+	for(int dx = -1; dx <= 1; dx ++) {
+		for(int dy = -1; dy <= 1; dy ++) {
+			constraint& c = constraints[index(x + dx, y + dy)];
+			if(c.active) {
+				c.unknown &= ~(1 << ((1 - dx) * 3 + (1 - dy)));
+				c.mines --;
+				c.active = c.unknown != 0;
+				push(index(x + dx, y + dy));
+			}
+		}
+	}
+}
+
+void Solver::mark_window(int i, uint64_t window, bool mines) {
+	int x = i / MAT_WIDTH;
+	int y = i % MAT_WIDTH;
+
+	while(window) {
+		int bit = __builtin_ctzll(window);
+		window &= window - 1;
+		int tile = index(x - 3 + bit / 7, y - 3 + bit % 7);
+		if(mines) {
+			mark_mine(tile);
+		} else {
+			mark_safe(tile);
+		}
+	}
+}
+
+// a number with all its mines found, or with as many unknown
+// neighbours as mines left
+bool Solver::check_single(int i) {
+	constraint c = constraints[i];
+	int unknown = __builtin_popcount(c.unknown);
+
+	if(c.mines == 0) {
+		mark_window(i, spread(c.unknown, 3, 3), false);
+		return true;
+	}
+	if(c.mines == unknown) {
+		mark_window(i, spread(c.unknown, 3, 3), true);
+		return true;
+	}
+	return false;
+}
+
+// if the mines the first number needs outside the second number's tiles
+// fill all those tiles, they are mines and the second number's other
+// tiles are safe (the subset rule is the case with no such tiles)
+bool Solver::check_pair(int i, int j) {
+	const constraint& a = constraints[i];
+	const constraint& b = constraints[j];
+	int dx = j / MAT_WIDTH - i / MAT_WIDTH;
+	int dy = j % MAT_WIDTH - i % MAT_WIDTH;
+
+	uint64_t mask_a = spread(a.unknown, 3, 3);
+	uint64_t mask_b = spread(b.unknown, 3 + dx, 3 + dy);
+	uint64_t only_a = mask_a & ~mask_b;
+	uint64_t only_b = mask_b & ~mask_a;
+	if(only_a == mask_a) { // nothing in common
+		return false;
+	}
+
+	if(a.mines - b.mines == __builtin_popcountll(only_a)) {
+		if(only_a | only_b) {
+			mark_window(i, only_a, true);
+			mark_window(i, only_b, false);
+			return true;
+		}
+	} else if(b.mines - a.mines == __builtin_popcountll(only_b)) {
+		mark_window(i, only_b, true);
+		mark_window(i, only_a, false);
+		return true;
+	}
+	return false;
+}
+
+bool Solver::check_pattern(int i, bool vertical) {
+	int x = i / MAT_WIDTH;
+	int y = i % MAT_WIDTH;
+	int unknown = 0;
+	int mines[3];
+
+	for(int k = 0; k < 3; k ++) {
+		int nx = vertical ? x + k - 1 : x;
+		int ny = vertical ? y : y + k - 1;
+		// a wall is no number: it does not bound the tiles next to it
+		if(is_hidden(nx, ny) || field[nx][ny] == WALL) {
+			return false;
+		}
+
+		const constraint& c = constraints[index(nx, ny)];
+		mines[k] = 0;
+		if(!c.active) {
+			continue;
+		}
+		if(c.mines < 0 || c.mines > PATTERN_MAX_MINES) {
+			return false;
+		}
+		mines[k] = c.mines;
+		for(int bits = c.unknown; bits; bits &= bits - 1) {
+			unknown |= 1 << window_bit[vertical][k][__builtin_ctz(bits)];
+		}
+	}
+
+	uint32_t forced = pattern_table[pattern_key(unknown, mines[0], mines[1], mines[2])];
+	if(forced == 0) {
+		return false;
+	}
+
+	size_t found = safe_tiles.size() + mine_tiles.size();
+	for(uint32_t bits = forced; bits; bits &= bits - 1) {
+		int bit = __builtin_ctz(bits);
+		int cell = window_tile[bit % PATTERN_MINES_SHIFT];
+		int r = cell / 5 - 1;
+		int c = cell % 5 - 2;
+		int tile = vertical ? index(x + c, y + r) : index(x + r, y + c);
+		if(bit >= PATTERN_MINES_SHIFT) {
+			mark_mine(tile);
+		} else {
+			mark_safe(tile);
+		}
+	}
+	return safe_tiles.size() + mine_tiles.size() > found;
+}
+
+// the rows centered on i, and the rows i ends, which changed with it
+bool Solver::check_patterns(int i) {
+	static const int sides[4] = {-1, 1, -MAT_WIDTH, MAT_WIDTH};
+	bool found = check_pattern(i, false);
+
+	if(constraints[i].active) {
+		found |= check_pattern(i, true);
+	}
+	for(int k = 0; k < 4; k ++) {
+		int j = i + sides[k];
+		if(constraints[j].active) {
+			found |= check_pattern(j, k >= 2);
+		}
+	}
+	return found;
+}
+
+int Solver::solve() {
+	size_t found = safe_tiles.size() + mine_tiles.size();
+
+	while(!work_list.empty()) {
+		int i = work_list.back();
+		work_list.pop_back();
+		queued[i] = 0;
+
+		if(!constraints[i].active || check_single(i)) {
+			continue;
+		}
+		// one lookup settles most rows, the pairs are what is left
+		if((check_patterns(i) && !constraints[i].active) || !pair_rules) {
+			continue;
+		}
+
+		int x = i / MAT_WIDTH;
+		int y = i % MAT_WIDTH;
+		for(int nx = std::max(1, x - 2); nx <= std::min(height, x + 2); nx ++) {
+			for(int ny = std::max(1, y - 2); ny <= std::min(width, y + 2); ny ++) {
+				int j = index(nx, ny);
+				if(j != i && constraints[j].active && check_pair(i, j)) {
+					break;
+				}
+			}
+			if(!constraints[i].active) {
+				break;
+			}
+		}
+	}
+
+	return safe_tiles.size() + mine_tiles.size() - found;
+}
+
+void Solver::use_pair_rules(bool use) {
+	pair_rules = use;
+}
+
+bool Solver::is_safe(int x, int y) {
+	return test(safe_bits, index(x, y));
+}
+
+bool Solver::is_mine(int x, int y) {
+	return test(mine_bits, index(x, y));
+}
+
+const std::vector<int>& Solver::get_safe_tiles() {
+	return safe_tiles;
+}
+
+const std::vector<int>& Solver::get_mine_tiles() {
+	return mine_tiles;
+}
+
+bool Solver::closest_safe(int& x, int& y) {
+	int best = -1;
+	int best_distance = 0;
+
+	// the tiles revealed since are dropped, so the list only holds the
+	// safe tiles still hidden and stays short as the game goes on
+	size_t kept = 0;
+	for(size_t k = 0; k < safe_tiles.size(); k ++) {
+		int i = safe_tiles[k];
+		int tx = i / MAT_WIDTH;
+		int ty = i % MAT_WIDTH;
+		if(field[tx][ty] != EMPTYH && field[tx][ty] != FLAGT) {
+			continue;
+		}
+		safe_tiles[kept ++] = i;
+
+		int distance = std::max(std::abs(tx - x), std::abs(ty - y));
+		if(best < 0 || distance < best_distance) {
+			best = i;
+			best_distance = distance;
+		}
+	}
+	safe_tiles.resize(kept);
+
+	if(best < 0) {
+		return false;
+	}
+	x = best / MAT_WIDTH;
+	y = best % MAT_WIDTH;
+	return true;
+}
@@ -0,0 +1,108 @@
+/**
+	Solver.h
+		Deterministic solver that finds, using only what the player can see,
+	every hidden tile that is provably safe or provably a mine. It applies
+	the single number rules (a number with all its mines found, or with as
+	many hidden neighbours as missing mines), then looks the rows of three
+	numbers around it up in the table of local patterns ('Patterns.h'), and
+	falls back to the subset/superset rules between numbers at most two
+	tiles apart. The hidden neighbours of a
+	number are kept as a 3x3 bitmask, two numbers are compared by placing
+	their masks on a common 7x7 window of a 64 bit word. Flags are ignored,
+	since the player may have placed them wrong.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _SOLVER_H_
+#define _SOLVER_H_
+
+#include <vector>
+#include <stdint.h>
+#include "Utils.h"
+#include "Patterns.h"
+
+
+class Solver {
+private:
+	// a revealed number and its hidden neighbours that are not known yet
+	struct constraint {
+		// 3x3 mask, bit (dx + 1) * 3 + (dy + 1) for the neighbour (x+dx, y+dy)
+		uint16_t unknown;
+		// mines among the unknown neighbours
+		int8_t mines;
+		bool active;
+	};
+
+	int height;
+	int width;
+	char (*field)[MAT_WIDTH];
+	bool pair_rules;
+	// tiles deduced safe and deduced mines, one bit per tile
+	std::vector<uint64_t> safe_bits;
+	std::vector<uint64_t> mine_bits;
+	// the same tiles, in the order they were found
+	std::vector<int> safe_tiles;
+	std::vector<int> mine_tiles;
+	// constraints indexed by tile, the ones to check again and whether
+	// a tile is already waiting in the work list
+	std::vector<constraint> constraints;
+	std::vector<int> work_list;
+	std::vector<char> queued;
+	// window bit of every neighbour of the three numbers of a pattern,
+	// [vertical][number][neighbour], and the window tiles by bit (r * 5 + c)
+	static int8_t window_bit[2][3][9];
+	static int8_t window_tile[PATTERN_CELLS];
+
+	static int index(int x, int y) { return x * MAT_WIDTH + y; }
+	static bool test(const std::vector<uint64_t>& bits, int i) {
+		return bits[i / 64] & (1ULL << (i % 64));
+	}
+	static void set(std::vector<uint64_t>& bits, int i) {
+		bits[i / 64] |= 1ULL << (i % 64);
+	}
+	// spreads a 3x3 mask over the 7x7 window, its center at (x, y) of
+	// the window (1 <= x, y <= 5)
+	static uint64_t spread(uint16_t mask, int x, int y);
+
+	bool is_hidden(int x, int y);
+	void build_constraint(int x, int y);
+	void push(int i);
+	void mark_safe(int i);
+	void mark_mine(int i);
+	// marks every tile of a 7x7 window mask centered on tile i
+	void mark_window(int i, uint64_t window, bool mines);
+	bool check_single(int i);
+	bool check_pair(int i, int j);
+	// the row (vertical or not) of three tiles centered on the number i
+	bool check_pattern(int i, bool vertical);
+	bool check_patterns(int i);
+
+public:
+	Solver();
+
+	// forgets all deductions and reads the visible field
+	void load(char visible_field[][MAT_WIDTH], int height, int width);
+	// reads the tiles from visible_field from now on, a copy of the field
+	// the solver was kept up to date with (for a copy of the solver)
+	void attach(char visible_field[][MAT_WIDTH]);
+	// applies the rules until nothing new can be found; returns the
+	// number of new tiles deduced
+	int solve();
+	// without the pair rules, only the single numbers and the patterns
+	// are used (on by default)
+	void use_pair_rules(bool use);
+	// the tile (x, y) was revealed: only the numbers around it are read
+	// again, and the next solve starts from them (flags change nothing)
+	void update(int x, int y);
+	bool is_safe(int x, int y);
+	bool is_mine(int x, int y);
+	// deduced tiles, in the order they were found (x * MAT_WIDTH + y);
+	// safe tiles revealed since are skipped by the callers
+	const std::vector<int>& get_safe_tiles();
+	const std::vector<int>& get_mine_tiles();
+	// the hidden safe tile closest to (x, y); false if there is none.
+	// Forgets the safe tiles revealed since they were found
+	bool closest_safe(int& x, int& y);
+};
+
+#endif // _SOLVER_H_
@@ -0,0 +1,836 @@
+/**
+	SolverBench.cpp
+		Measures the speed and checks the answers of the solver components
+	on a fixed corpus of positions ('solver_corpus.txt'), so that changes
+	to them can be compared on the same ground. Every position of the
+	corpus is what a player saw at some point of a game, on every preset,
+	sorted by how hard its frontier is (the layouts the enumeration had
+	to try), and comes with its true answers:
+	which hidden tiles are safe or mines whatever the layout, the exact
+	probability of the others and, with few unknown tiles left, the best
+	chance to win. The answers are worked out by a reference enumeration
+	that does not use the solver, while the corpus is made.
+
+	Every position is given in turn to the solver (the single number rules
+	and the patterns, then the pair rules too), to the probability engine
+	and to the endgame search. A wrong answer is a tile deduced safe or a
+	mine that is not, a probability that is off, or a best chance to win
+	that differs; the positions per second of every component are printed
+	with the wrong answers.
+
+	Corpus format (version 1): comment lines start with '#', then
+		version 1
+		position PRESET CLASS HEIGHT WIDTH BOMBS
+		HEIGHT rows of WIDTH tiles: '.' and '1'-'8' revealed, and hidden
+			'S' safe, 'M' a mine, '?' unknown next to a number, '-' unknown
+			far from the numbers
+		frontier P1 P2 ... (chance of a mine of the '?' tiles, reading order)
+		interior P (of the '-' tiles, -1 if there are none)
+		win W (best chance to win, -1 if not searched)
+
+	Usage: './minesweeper-solver-bench [-c FILE] [-r REPEATS]'
+	   or: './minesweeper-solver-bench -g FILE [-n PER_CLASS] [-s SEED]',
+	which plays games and writes a new corpus.
+
+	@author Sergiu Constantinescu
+*/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include "GameState.h"
+#include "GameSettings.h"
+#include "IOScript.h"
+#include "Solver.h"
+#include "Probability.h"
+#include "EndgameSolver.h"
+#include "Strategy.h"
+#include "Utils.h"
+
+#define CORPUS_FILE		"solver_corpus.txt"
+#define CORPUS_VERSION	1
+// the classes of the positions, by the steps the reference enumeration
+// took: below the limit of the class
+#define NR_OF_CLASSES	5
+static const char* class_names[NR_OF_CLASSES] = {
+	"trivial", "easy", "medium", "hard", "very-hard"
+};
+static const long class_limits[NR_OF_CLASSES] = {100, 1000, 10000, 100000, 1L << 62};
+// enumeration steps allowed to the reference for one position, as many as
+// the probability engine is allowed by default
+#define REFERENCE_NODE_LIMIT	20000000L
+// largest error allowed on a probability, and on a chance to win (the
+// endgame search keeps its values as floats)
+#define PROBABILITY_TOLERANCE	1e-9
+#define WIN_TOLERANCE			1e-5
+
+
+// a position and its true answers
+struct corpus_position {
+	int preset;
+	int hardness;
+	int height;
+	int width;
+	int bombs;
+	// what the player sees, with the borders
+	char field[MAT_HEIGHT][MAT_WIDTH];
+	// the same with the answers on the hidden tiles ('S', 'M', '?', '-')
+	char truth[MAT_HEIGHT][MAT_WIDTH];
+	std::vector<double> frontier;
+	double interior;
+	double win;
+};
+
+// exact mine probabilities by plain enumeration, without the solver
+class Reference {
+private:
+	struct group {
+		std::vector<int> vars;
+		std::vector<long double> counts;
+		std::vector<std::vector<long double> > var_counts;
+	};
+
+	std::vector<int> var_tiles;
+	std::vector<int> tile_var;
+	std::vector<std::vector<int> > var_numbers;
+	std::vector<std::vector<int> > number_vars;
+	std::vector<int> number_mines;
+	std::vector<int> placed;
+	std::vector<int> unassigned;
+	std::vector<char> value;
+	long nodes;
+
+	bool enumerate(group& g, size_t pos, int mines, int bombs);
+
+public:
+	Reference() : tile_var(MAT_HEIGHT * MAT_WIDTH, -1), nodes(0) {}
+	// fills the answers of p from its field; false if it takes too long
+	bool solve(corpus_position& p);
+	// enumeration steps taken by the last position
+	long get_nodes() { return nodes; }
+};
+
+bool Reference::enumerate(group& g, size_t pos, int mines, int bombs) {
+	if(++ nodes > REFERENCE_NODE_LIMIT) {
+		return false;
+	}
+	if(pos == g.vars.size()) {
+		g.counts[mines] += 1.0;
+		for(size_t v = 0; v < g.vars.size(); v ++) {
+			if(value[g.vars[v]]) {
+				g.var_counts[mines][v] += 1.0;
+			}
+		}
+		return true;
+	}
+
+	int var = g.vars[pos];
+	for(int mine = 0; mine <= 1 && mines + mine <= bombs; mine ++) {
+		bool ok = true;
+		value[var] = mine;
+		const std::vector<int>& ns = var_numbers[var];
+		for(size_t k = 0; k < ns.size(); k ++) {
+			placed[ns[k]] += mine;
+			unassigned[ns[k]] --;
+			ok = ok && placed[ns[k]] <= number_mines[ns[k]] &&
+					placed[ns[k]] + unassigned[ns[k]] >= number_mines[ns[k]];
+		}
+		bool done = !ok || enumerate(g, pos + 1, mines + mine, bombs);
+		for(size_t k = 0; k < ns.size(); k ++) {
+			placed[ns[k]] -= mine;
+			unassigned[ns[k]] ++;
+		}
+		if(!done) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// ways to place m mines in n tiles, as a logarithm
+static double log_binomial(int n, int m) {
+	return std::lgamma(n + 1.0) - std::lgamma(m + 1.0) - std::lgamma(n - m + 1.0);
+}
+
+static std::vector<long double> convolve(const std::vector<long double>& a,
+										const std::vector<long double>& b) {
+	std::vector<long double> result(a.size() + b.size() - 1, 0.0);
+	for(size_t i = 0; i < a.size(); i ++) {
+		for(size_t j = 0; j < b.size(); j ++) {
+			result[i + j] += a[i] * b[j];
+		}
+	}
+	return result;
+}
+
+bool Reference::solve(corpus_position& p) {
+	int h = p.height;
+	int w = p.width;
+	std::vector<int> interior;
+
+	var_tiles.clear();
+	number_vars.clear();
+	number_mines.clear();
+	for(int i = 1; i <= h; i ++) {
+		for(int j = 1; j <= w; j ++) {
+			tile_var[i * MAT_WIDTH + j] = -1;
+			if(p.field[i][j] != EMPTYH) {
+				continue;
+			}
+			bool next_to_number = false;
+			for(int dx = -1; dx <= 1; dx ++) {
+				for(int dy = -1; dy <= 1; dy ++) {
+					char n = p.field[i + dx][j + dy];
+					next_to_number = next_to_number || (n >= '1' && n <= '8');
+				}
+			}
+			if(next_to_number) {
+				tile_var[i * MAT_WIDTH + j] = var_tiles.size();
+				var_tiles.push_back(i * MAT_WIDTH + j);
+			} else {
+				interior.push_back(i * MAT_WIDTH + j);
+			}
+		}
+	}
+	var_numbers.assign(var_tiles.size(), std::vector<int>());
+	for(int i = 1; i <= h; i ++) {
+		for(int j = 1; j <= w; j ++) {
+			char ch = p.field[i][j];
+			if(ch < '1' || ch > '8') {
+				continue;
+			}
+			std::vector<int> vars;
+			for(int dx = -1; dx <= 1; dx ++) {
+				for(int dy = -1; dy <= 1; dy ++) {
+					int v = tile_var[(i + dx) * MAT_WIDTH + j + dy];
+					if(v >= 0) {
+						vars.push_back(v);
+						var_numbers[v].push_back(number_vars.size());
+					}
+				}
+			}
+			number_vars.push_back(vars);
+			number_mines.push_back(ch - '0');
+		}
+	}
+
+	// groups of variables linked by numbers, enumerated one by one
+	std::vector<group> groups;
+	std::vector<char> seen(var_tiles.size(), 0);
+	placed.assign(number_vars.size(), 0);
+	unassigned.resize(number_vars.size());
+	for(size_t n = 0; n < number_vars.size(); n ++) {
+		unassigned[n] = number_vars[n].size();
+	}
+	value.assign(var_tiles.size(), 0);
+	nodes = 0;
+	for(size_t start = 0; start < var_tiles.size(); start ++) {
+		if(seen[start]) {
+			continue;
+		}
+		group g;
+		seen[start] = 1;
+		g.vars.push_back(start);
+		for(size_t k = 0; k < g.vars.size(); k ++) {
+			const std::vector<int>& ns = var_numbers[g.vars[k]];
+			for(size_t n = 0; n < ns.size(); n ++) {
+				for(size_t v = 0; v < number_vars[ns[n]].size(); v ++) {
+					int var = number_vars[ns[n]][v];
+					if(!seen[var]) {
+						seen[var] = 1;
+						g.vars.push_back(var);
+					}
+				}
+			}
+		}
+		g.counts.assign(g.vars.size() + 1, 0.0);
+		g.var_counts.assign(g.vars.size() + 1,
+							std::vector<long double>(g.vars.size(), 0.0));
+		if(!enumerate(g, 0, 0, p.bombs)) {
+			return false;
+		}
+		groups.push_back(g);
+	}
+
+	// the ways to place the other mines far from the numbers, scaled
+	int nr_of_interior = interior.size();
+	int frontier_max = var_tiles.size();
+	std::vector<long double> weight(frontier_max + 1, 0.0);
+	double top = -1e300;
+	for(int m = 0; m <= frontier_max; m ++) {
+		int rest = p.bombs - m;
+		if(rest >= 0 && rest <= nr_of_interior) {
+			top = std::max(top, log_binomial(nr_of_interior, rest));
+		}
+	}
+	for(int m = 0; m <= frontier_max; m ++) {
+		int rest = p.bombs - m;
+		if(rest >= 0 && rest <= nr_of_interior) {
+			weight[m] = std::exp((long double)(log_binomial(nr_of_interior, rest) - top));
+		}
+	}
+
+	size_t nr_of_groups = groups.size();
+	std::vector<std::vector<long double> > prefix(nr_of_groups + 1);
+	std::vector<std::vector<long double> > suffix(nr_of_groups + 1);
+	prefix[0] = std::vector<long double>(1, 1.0);
+	suffix[nr_of_groups] = std::vector<long double>(1, 1.0);
+	for(size_t g = 0; g < nr_of_groups; g ++) {
+		prefix[g + 1] = convolve(prefix[g], groups[g].counts);
+	}
+	for(size_t g = nr_of_groups; g > 0; g --) {
+		suffix[g - 1] = convolve(groups[g - 1].counts, suffix[g]);
+	}
+	const std::vector<long double>& total = prefix[nr_of_groups];
+	long double sum = 0.0;
+	long double interior_mines = 0.0;
+	for(size_t m = 0; m < total.size(); m ++) {
+		sum += total[m] * weight[m];
+		interior_mines += total[m] * weight[m] * (p.bombs - (int)m);
+	}
+	if(sum <= 0.0) {
+		return false;
+	}
+
+	// the answers; a tile is known when no layout of any weight says
+	// otherwise, which the sums (of integers, some scaled) tell exactly
+	for(int i = 0; i <= h + 1; i ++) {
+		for(int j = 0; j <= w + 1; j ++) {
+			p.truth[i][j] = p.field[i][j];
+		}
+	}
+	std::vector<double> probability(var_tiles.size(), 0.0);
+	std::vector<char> known(var_tiles.size(), 0);
+	for(size_t g = 0; g < nr_of_groups; g ++) {
+		std::vector<long double> others = convolve(prefix[g], suffix[g + 1]);
+		const group& gr = groups[g];
+		for(size_t v = 0; v < gr.vars.size(); v ++) {
+			long double mine = 0.0;
+			long double safe = 0.0;
+			for(size_t k = 0; k < gr.counts.size(); k ++) {
+				long double rest = 0.0;
+				for(size_t j = 0; j < others.size(); j ++) {
+					rest += others[j] * weight[k + j];
+				}
+				mine += gr.var_counts[k][v] * rest;
+				safe += (gr.counts[k] - gr.var_counts[k][v]) * rest;
+			}
+			int var = gr.vars[v];
+			probability[var] = (double)(mine / sum);
+			known[var] = mine == 0.0 ? 'S' : safe == 0.0 ? 'M' : 0;
+		}
+	}
+	p.frontier.clear();
+	for(size_t v = 0; v < var_tiles.size(); v ++) {
+		int t = var_tiles[v];
+		p.truth[t / MAT_WIDTH][t % MAT_WIDTH] = known[v] ? known[v] : '?';
+		if(!known[v]) {
+			p.frontier.push_back(probability[v]);
+		}
+	}
+	// the '?' tiles are listed in reading order, the variables too
+
+	p.interior = -1.0;
+	if(nr_of_interior > 0) {
+		p.interior = (double)(interior_mines / sum / nr_of_interior);
+		char mark = interior_mines == 0.0 ? 'S' :
+					interior_mines == sum * nr_of_interior ? 'M' : '-';
+		for(size_t k = 0; k < interior.size(); k ++) {
+			p.truth[interior[k] / MAT_WIDTH][interior[k] % MAT_WIDTH] = mark;
+		}
+	}
+	return true;
+}
+
+void write_position(std::ostream& out, const corpus_position& p) {
+	char number[32];
+
+	out << "position " << p.preset << " " << class_names[p.hardness] << " "
+		<< p.height << " " << p.width << " " << p.bombs << std::endl;
+	for(int i = 1; i <= p.height; i ++) {
+		out << std::string(&p.truth[i][1], p.width) << std::endl;
+	}
+	out << "frontier";
+	for(size_t k = 0; k < p.frontier.size(); k ++) {
+		snprintf(number, sizeof(number), " %.12g", p.frontier[k]);
+		out << number;
+	}
+	snprintf(number, sizeof(number), "%.12g", p.interior);
+	out << std::endl << "interior " << number << std::endl;
+	snprintf(number, sizeof(number), "%.9g", p.win);
+	out << "win " << number << std::endl;
+}
+
+// plays games of every preset with the probability strategy and keeps
+// some of the positions met: per_class of every class, and per_class
+// in reach of the endgame search
+bool generate(const char* path, int per_class, uint64_t base_seed) {
+	std::ofstream out(path);
+	if(!out) {
+		return false;
+	}
+	out << "# Minesweeper solver corpus, made by"
+		<< " './minesweeper-solver-bench -g' (seed " << base_seed << ")" << std::endl;
+	out << "# tiles: '.' '1'-'8' revealed; hidden 'S' safe, 'M' mine, '?' unknown"
+		<< " next to a number, '-' unknown far from the numbers" << std::endl;
+	out << "version " << CORPUS_VERSION << std::endl;
+
+	GameSettings settings;
+	IOScript io_script(&settings);
+	GameState<IOScript> game(&io_script);
+	ProbabilityStrategy strategy;
+	Reference reference;
+	EndgameSolver endgame;
+	corpus_position* p = new corpus_position();
+
+	for(int preset = 1; preset <= 4; preset ++) {
+		settings.set_diff(preset);
+		// the last one counts the endgame positions
+		std::vector<int> kept(NR_OF_CLASSES + 1, 0);
+		int full = 0;
+		for(uint64_t g = 0; g < 5000 && full <= NR_OF_CLASSES; g ++) {
+			uint64_t seed = splitmix64(base_seed + preset * 1000003 + g);
+			int x = 1 + seed % settings.get_height();
+			int y = 1 + (seed >> 32) % settings.get_width();
+			settings.set_seed(seed | 1);
+			game.start_game(&settings);
+			strategy.start(seed);
+			game.click(x, y);
+
+			// a few positions of every game, from all its stages
+			uint64_t pick = seed;
+			while(!game.is_won() && !game.is_lost() && full <= NR_OF_CLASSES) {
+				pick = splitmix64(pick);
+				if(pick % 6 == 0) {
+					p->preset = preset;
+					p->height = game.get_height();
+					p->width = game.get_width();
+					p->bombs = game.get_bombs();
+					char (*field)[MAT_WIDTH] = game.get_visible_field();
+					for(int i = 0; i <= p->height + 1; i ++) {
+						for(int j = 0; j <= p->width + 1; j ++) {
+							p->field[i][j] = field[i][j];
+						}
+					}
+					if(reference.solve(*p)) {
+						int c = 0;
+						while(reference.get_nodes() >= class_limits[c]) {
+							c ++;
+						}
+						int ex = x;
+						int ey = y;
+						double mine;
+						p->hardness = c;
+						if(!endgame.solve(p->field, p->height, p->width,
+											p->bombs, ex, ey, p->win, mine)) {
+							p->win = -1.0;
+						}
+						bool more = kept[c] < per_class;
+						bool more_endgame = p->win >= 0.0 &&
+											kept[NR_OF_CLASSES] < per_class;
+						if(more || more_endgame) {
+							write_position(out, *p);
+							full += more && ++ kept[c] == per_class;
+							full += p->win >= 0.0 &&
+									++ kept[NR_OF_CLASSES] == per_class;
+						}
+					}
+				}
+
+				bool guess;
+				if(!strategy.choose(game.get_visible_field(), game.get_height(),
+									game.get_width(), game.get_bombs(),
+									x, y, guess)) {
+					break;
+				}
+				game.click(x, y);
+			}
+		}
+		std::cout << "Preset " << preset << ":";
+		for(int c = 0; c < NR_OF_CLASSES; c ++) {
+			std::cout << " " << kept[c] << " " << class_names[c];
+		}
+		std::cout << ", " << kept[NR_OF_CLASSES] << " endgame" << std::endl;
+	}
+	delete p;
+	return true;
+}
+
+// reads the corpus; false, with the line, if it is not a valid one
+bool load(const char* path, std::vector<corpus_position*>& corpus, int& line_nr) {
+	std::ifstream in(path);
+	std::string line;
+	bool versioned = false;
+
+	line_nr = 0;
+	if(!in) {
+		return false;
+	}
+	while(std::getline(in, line)) {
+		line_nr ++;
+		if(line.empty() || line[0] == '#') {
+			continue;
+		}
+		std::istringstream words(line);
+		std::string key;
+		words >> key;
+		if(key == "version") {
+			int version = 0;
+			words >> version;
+			if(version != CORPUS_VERSION) {
+				return false;
+			}
+			versioned = true;
+			continue;
+		}
+		if(key != "position" || !versioned) {
+			return false;
+		}
+
+		corpus_position* p = new corpus_position();
+		corpus.push_back(p);
+		std::string hardness;
+		words >> p->preset >> hardness >> p->height >> p->width >> p->bombs;
+		p->hardness = std::find(class_names, class_names + NR_OF_CLASSES,
+								hardness) - class_names;
+		if(!words || p->hardness == NR_OF_CLASSES ||
+			p->height < 1 || p->height > MAX_HEIGHT ||
+			p->width < 1 || p->width > MAX_WIDTH) {
+			return false;
+		}
+		for(int i = 0; i <= p->height + 1; i ++) {
+			for(int j = 0; j <= p->width + 1; j ++) {
+				p->field[i][j] = WALL;
+				p->truth[i][j] = WALL;
+			}
+		}
+		for(int i = 1; i <= p->height; i ++) {
+			line_nr ++;
+			if(!std::getline(in, line) || (int)line.size() != p->width) {
+				return false;
+			}
+			for(int j = 1; j <= p->width; j ++) {
+				char ch = line[j - 1];
+				p->truth[i][j] = ch;
+				bool hidden = ch == 'S' || ch == 'M' || ch == '?' || ch == '-';
+				p->field[i][j] = hidden ? EMPTYH : ch;
+			}
+		}
+
+		double value;
+		line_nr ++;
+		std::getline(in, line);
+		words.clear();
+		words.str(line);
+		words >> key;
+		if(key != "frontier") {
+			return false;
+		}
+		while(words >> value) {
+			p->frontier.push_back(value);
+		}
+		line_nr ++;
+		std::getline(in, line);
+		words.clear();
+		words.str(line);
+		if(!(words >> key >> p->interior) || key != "interior") {
+			return false;
+		}
+		line_nr ++;
+		std::getline(in, line);
+		words.clear();
+		words.str(line);
+		if(!(words >> key >> p->win) || key != "win") {
+			return false;
+		}
+	}
+	return versioned;
+}
+
+// what one component did over the corpus
+struct bench_result {
+	uint64_t positions;
+	uint64_t wrong;
+	// tiles deduced, and tiles that are known (solver only)
+	uint64_t found;
+	uint64_t known;
+	double seconds;
+	// time taken by every class of positions
+	double class_seconds[NR_OF_CLASSES];
+	uint64_t class_positions[NR_OF_CLASSES];
+
+	bench_result() : positions(0), wrong(0), found(0), known(0), seconds(0.0) {
+		for(int c = 0; c < NR_OF_CLASSES; c ++) {
+			class_seconds[c] = 0.0;
+			class_positions[c] = 0;
+		}
+	}
+};
+
+void report_wrong(const char* component, const corpus_position& p,
+					size_t index, const char* what) {
+	std::cout << "  wrong: " << component << ", position " << index + 1
+				<< " (preset " << p.preset << ", " << class_names[p.hardness]
+				<< "): " << what << std::endl;
+}
+
+// the solver deduces no tile that is not known
+bool check_solver(Solver& solver, const corpus_position& p, bench_result& r,
+					std::string& what) {
+	const std::vector<int>& safe = solver.get_safe_tiles();
+	const std::vector<int>& mines = solver.get_mine_tiles();
+	for(size_t k = 0; k < safe.size(); k ++) {
+		if(p.truth[safe[k] / MAT_WIDTH][safe[k] % MAT_WIDTH] != 'S') {
+			what = "a tile deduced safe is not";
+			return false;
+		}
+	}
+	for(size_t k = 0; k < mines.size(); k ++) {
+		if(p.truth[mines[k] / MAT_WIDTH][mines[k] % MAT_WIDTH] != 'M') {
+			what = "a tile deduced a mine is not";
+			return false;
+		}
+	}
+	r.found += safe.size() + mines.size();
+	for(int i = 1; i <= p.height; i ++) {
+		for(int j = 1; j <= p.width; j ++) {
+			r.known += p.truth[i][j] == 'S' || p.truth[i][j] == 'M';
+		}
+	}
+	return true;
+}
+
+bool check_probability(ProbabilityEngine& probability, const corpus_position& p,
+						std::string& what) {
+	size_t next = 0;
+	for(int i = 1; i <= p.height; i ++) {
+		for(int j = 1; j <= p.width; j ++) {
+			double expected;
+			switch(p.truth[i][j]) {
+				case 'S': expected = 0.0; break;
+				case 'M': expected = 1.0; break;
+				case '?':
+					if(next == p.frontier.size()) {
+						what = "the corpus lists too few probabilities";
+						return false;
+					}
+					expected = p.frontier[next ++];
+					break;
+				case '-': expected = p.interior; break;
+				default: continue;
+			}
+			double got = probability.get_probability(i, j);
+			if(std::fabs(got - expected) > PROBABILITY_TOLERANCE) {
+				char text[96];
+				snprintf(text, sizeof(text), "tile (%d, %d) is %.12g, not %.12g",
+							i, j, got, expected);
+				what = text;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// the best chance to win, and a move that is safe if any tile is known safe
+bool check_endgame(double win, int x, int y, const corpus_position& p,
+					std::string& what) {
+	bool any_safe = false;
+	for(int i = 1; i <= p.height; i ++) {
+		for(int j = 1; j <= p.width; j ++) {
+			any_safe = any_safe || p.truth[i][j] == 'S';
+		}
+	}
+	if(std::fabs(win - p.win) > WIN_TOLERANCE) {
+		char text[96];
+		snprintf(text, sizeof(text), "chance to win %.7f, not %.7f", win, p.win);
+		what = text;
+		return false;
+	}
+	if(p.truth[x][y] == 'M' || (any_safe && p.truth[x][y] != 'S')) {
+		what = "the move is not the safe tile it should be";
+		return false;
+	}
+	return true;
+}
+
+// runs component k on every position, repeats times, checking the answers
+// of the first round
+bench_result run(int k, const char* name, std::vector<corpus_position*>& corpus,
+					int repeats) {
+	bench_result r;
+	Solver solver;
+	ProbabilityEngine probability;
+	EndgameSolver endgame;
+	solver.use_pair_rules(k == 1);
+
+	for(int round = 0; round < repeats; round ++) {
+		for(size_t n = 0; n < corpus.size(); n ++) {
+			corpus_position& p = *corpus[n];
+			if(k == 3 && p.win < 0.0) {
+				continue;
+			}
+
+			bool ok = true;
+			double win = 0.0;
+			int x = 1;
+			int y = 1;
+			auto start = std::chrono::steady_clock::now();
+			if(k <= 1) {
+				solver.load(p.field, p.height, p.width);
+				solver.solve();
+			} else if(k == 2) {
+				ok = probability.compute(p.field, p.height, p.width, p.bombs);
+			} else {
+				double mine;
+				ok = endgame.solve(p.field, p.height, p.width, p.bombs,
+									x, y, win, mine);
+			}
+			double seconds = std::chrono::duration<double>(
+								std::chrono::steady_clock::now() - start).count();
+			r.seconds += seconds;
+			r.class_seconds[p.hardness] += seconds;
+			r.class_positions[p.hardness] ++;
+			r.positions ++;
+			if(round > 0) {
+				continue;
+			}
+
+			std::string what = "gave up";
+			if(ok) {
+				if(k <= 1) {
+					ok = check_solver(solver, p, r, what);
+				} else if(k == 2) {
+					ok = check_probability(probability, p, what);
+				} else {
+					ok = check_endgame(win, x, y, p, what);
+				}
+			}
+			if(!ok) {
+				r.wrong ++;
+				report_wrong(name, p, n, what.c_str());
+			}
+		}
+	}
+	return r;
+}
+
+void usage() {
+	std::cout << "Usage: './minesweeper-solver-bench [-c FILE] [-r REPEATS]'"
+				<< std::endl;
+	std::cout << "   or: './minesweeper-solver-bench -g FILE [-n PER_CLASS]"
+				<< " [-s SEED]'" << std::endl;
+	std::cout << "\tFILE      - the corpus (default '" << CORPUS_FILE << "')"
+				<< std::endl;
+	std::cout << "\tREPEATS   - rounds over the corpus (default 100)" << std::endl;
+	std::cout << "\tPER_CLASS - positions of every class and preset"
+				<< " (default 6)" << std::endl;
+	std::cout << "\tSEED      - base seed of the games (default 1)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	const char* corpus_file = CORPUS_FILE;
+	const char* output = NULL;
+	int repeats = 100;
+	int per_class = 6;
+	uint64_t base_seed = 1;
+
+	for(int i = 1; i < argc; i ++) {
+		std::string arg(argv[i]);
+		if(i + 1 >= argc) {
+			usage();
+			return 1;
+		}
+		if(arg == "-c") {
+			corpus_file = argv[++ i];
+		} else if(arg == "-r") {
+			repeats = atoi(argv[++ i]);
+		} else if(arg == "-g") {
+			output = argv[++ i];
+		} else if(arg == "-n") {
+			per_class = atoi(argv[++ i]);
+		} else if(arg == "-s") {
+			base_seed = strtoull(argv[++ i], NULL, 10);
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if(repeats < 1 || per_class < 1) {
+		usage();
+		return 1;
+	}
+
+	if(output != NULL) {
+		if(!generate(output, per_class, base_seed)) {
+			std::cout << "Could not write '" << output << "'." << std::endl;
+			return 1;
+		}
+		std::cout << "Written to '" << output << "'." << std::endl;
+		return 0;
+	}
+
+	std::vector<corpus_position*> corpus;
+	int line_nr;
+	if(!load(corpus_file, corpus, line_nr)) {
+		if(line_nr == 0) {
+			std::cout << "Could not open the corpus '" << corpus_file << "'."
+						<< std::endl;
+		} else {
+			std::cout << "Could not read the corpus '" << corpus_file
+						<< "' (line " << line_nr << ")." << std::endl;
+		}
+		return 1;
+	}
+
+	const char* names[] = {"solver", "solver+pairs", "probability", "endgame"};
+	bench_result results[4];
+	std::cout << corpus.size() << " positions, " << repeats << " rounds"
+				<< std::endl;
+	for(int k = 0; k < 4; k ++) {
+		results[k] = run(k, names[k], corpus, repeats);
+	}
+
+	char line[160];
+	uint64_t wrong = 0;
+	std::cout << "Component      Positions  Wrong  Deduced/known  Positions/s";
+	for(int c = 0; c < NR_OF_CLASSES; c ++) {
+		snprintf(line, sizeof(line), " %10s", class_names[c]);
+		std::cout << line;
+	}
+	std::cout << std::endl;
+	for(int k = 0; k < 4; k ++) {
+		const bench_result& r = results[k];
+		char deduced[16] = "-";
+		if(k <= 1 && r.known > 0) {
+			snprintf(deduced, sizeof(deduced), "%.1f%%", 100.0 * r.found / r.known);
+		}
+		snprintf(line, sizeof(line), "%-14s %9llu %6llu %14s %12.0f", names[k],
+					(unsigned long long)(r.positions / repeats),
+					(unsigned long long)r.wrong, deduced,
+					r.seconds > 0.0 ? r.positions / r.seconds : 0.0);
+		std::cout << line;
+		for(int c = 0; c < NR_OF_CLASSES; c ++) {
+			if(r.class_positions[c] == 0) {
+				snprintf(line, sizeof(line), " %10s", "-");
+			} else {
+				snprintf(line, sizeof(line), " %10.0f",
+							r.class_positions[c] / r.class_seconds[c]);
+			}
+			std::cout << line;
+		}
+		std::cout << std::endl;
+		wrong += r.wrong;
+	}
+
+	for(size_t n = 0; n < corpus.size(); n ++) {
+		delete corpus[n];
+	}
+	return wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/**
+	Strategy.cpp
+		Contains the implementation of the functions declared in
+	'Strategy.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include "Strategy.h"
+#include "AutoPlayer.h"
+
+
+Strategy* Strategy::create(const std::string& name) {
+	if(name == "naive") {
+		return new NaiveStrategy();
+	}
+	if(name == "deterministic") {
+		return new DeterministicStrategy();
+	}
+	if(name == "probability") {
+		return new ProbabilityStrategy();
+	}
+	if(name == "endgame") {
+		return new EndgameStrategy();
+	}
+	return NULL;
+}
+
+const char* NaiveStrategy::get_name() {
+	return "naive";
+}
+
+void NaiveStrategy::start(uint64_t seed) {
+	rng.seed(seed);
+}
+
+bool NaiveStrategy::random_tile(char visible_field[][MAT_WIDTH], int height,
+								int width, Solver* solver, int& x, int& y) {
+	candidates.clear();
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			if(visible_field[i][j] == EMPTYH &&
+				(solver == NULL || !solver->is_mine(i, j))) {
+				candidates.push_back(i * MAT_WIDTH + j);
+			}
+		}
+	}
+	if(candidates.empty()) {
+		return false;
+	}
+
+	int tile = candidates[rng() % candidates.size()];
+	x = tile / MAT_WIDTH;
+	y = tile % MAT_WIDTH;
+	return true;
+}
+
+bool NaiveStrategy::choose(char visible_field[][MAT_WIDTH], int height,
+							int width, int bombs, int& x, int& y,
+							bool& guess) {
+	guess = true;
+	return random_tile(visible_field, height, width, NULL, x, y);
+}
+
+
+DeterministicStrategy::DeterministicStrategy() :
+	next(0)
+	{}
+
+const char* DeterministicStrategy::get_name() {
+	return "deterministic";
+}
+
+void DeterministicStrategy::start(uint64_t seed) {
+	NaiveStrategy::start(seed);
+	safe.clear();
+	next = 0;
+}
+
+bool DeterministicStrategy::safe_tile(char visible_field[][MAT_WIDTH],
+										int height, int width, int& x, int& y) {
+	for(int pass = 0; pass < 2; pass ++) {
+		while(next < safe.size()) {
+			int t = safe[next ++];
+			if(visible_field[t / MAT_WIDTH][t % MAT_WIDTH] == EMPTYH) {
+				x = t / MAT_WIDTH;
+				y = t % MAT_WIDTH;
+				return true;
+			}
+		}
+		if(pass == 0) {
+			solver.load(visible_field, height, width);
+			solver.solve();
+			safe = solver.get_safe_tiles();
+			next = 0;
+		}
+	}
+	return false;
+}
+
+// the solver is up to date: safe_tile just found nothing
+bool DeterministicStrategy::guess_tile(char visible_field[][MAT_WIDTH],
+										int height, int width, int bombs,
+										int& x, int& y) {
+	return random_tile(visible_field, height, width, &solver, x, y);
+}
+
+bool DeterministicStrategy::choose(char visible_field[][MAT_WIDTH],
+									int height, int width, int bombs,
+									int& x, int& y, bool& guess) {
+	guess = false;
+	if(safe_tile(visible_field, height, width, x, y)) {
+		return true;
+	}
+	guess = true;
+	return guess_tile(visible_field, height, width, bombs, x, y);
+}
+
+
+ProbabilityStrategy::ProbabilityStrategy() {
+	probability.set_node_limit(PLAYER_NODE_LIMIT);
+}
+
+const char* ProbabilityStrategy::get_name() {
+	return "probability";
+}
+
+// the first hidden tile not proven a mine if the probabilities take
+// too long, like the auto player
+bool ProbabilityStrategy::guess_tile(char visible_field[][MAT_WIDTH],
+										int height, int width, int bombs,
+										int& x, int& y) {
+	if(probability.compute(visible_field, height, width, bombs) &&
+		probability.safest(x, y)) {
+		return true;
+	}
+
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			if(visible_field[i][j] == EMPTYH && !solver.is_mine(i, j)) {
+				x = i;
+				y = j;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+
+const char* EndgameStrategy::get_name() {
+	return "endgame";
+}
+
+bool EndgameStrategy::guess_tile(char visible_field[][MAT_WIDTH],
+									int height, int width, int bombs,
+									int& x, int& y) {
+	double win, mine;
+	if(endgame.solve(visible_field, height, width, bombs, x, y, win, mine)) {
+		return true;
+	}
+	return ProbabilityStrategy::guess_tile(visible_field, height, width,
+											bombs, x, y);
+}
@@ -0,0 +1,108 @@
+/**
+	Strategy.h
+		Ways for a bot to play a game, behind one interface so that they
+	can be compared on the same boards (see 'minesweeper-tournament'). A
+	strategy is shown the visible field and picks the next tile to reveal:
+		- naive: a random hidden tile;
+		- deterministic: the tiles the solver proves safe, a random tile
+		  not proven a mine when stuck;
+		- probability: the proven safe tiles, the tile least likely to be
+		  a mine when stuck;
+		- endgame: as probability, but the move most likely to win once
+		  few tiles are unknown.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _STRATEGY_H_
+#define _STRATEGY_H_
+
+#include <random>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "Solver.h"
+#include "Probability.h"
+#include "EndgameSolver.h"
+#include "Utils.h"
+
+
+class Strategy {
+public:
+	virtual ~Strategy() { };
+	virtual const char* get_name() = 0;
+	// called before every game, with the game's seed
+	virtual void start(uint64_t seed) = 0;
+	// picks the next tile to reveal, (x, y) being the last one, and tells
+	// whether it is a guess (not proven safe); false if there is none
+	virtual bool choose(char visible_field[][MAT_WIDTH], int height, int width,
+						int bombs, int& x, int& y, bool& guess) = 0;
+	// a new strategy by name, NULL for an unknown name
+	static Strategy* create(const std::string& name);
+};
+
+
+class NaiveStrategy : public Strategy {
+protected:
+	std::mt19937_64 rng;
+	std::vector<int> candidates;
+
+	// a random hidden tile, not proven a mine if solver is not NULL
+	bool random_tile(char visible_field[][MAT_WIDTH], int height, int width,
+						Solver* solver, int& x, int& y);
+
+public:
+	const char* get_name();
+	void start(uint64_t seed);
+	bool choose(char visible_field[][MAT_WIDTH], int height, int width,
+				int bombs, int& x, int& y, bool& guess);
+};
+
+
+class DeterministicStrategy : public NaiveStrategy {
+protected:
+	Solver solver;
+	// the safe tiles of the last solve, the next one to look at
+	std::vector<int> safe;
+	size_t next;
+
+	// the next proven safe tile still hidden; solves the field again
+	// once the ones found before are all revealed
+	bool safe_tile(char visible_field[][MAT_WIDTH], int height, int width,
+					int& x, int& y);
+	virtual bool guess_tile(char visible_field[][MAT_WIDTH], int height,
+							int width, int bombs, int& x, int& y);
+
+public:
+	DeterministicStrategy();
+	const char* get_name();
+	void start(uint64_t seed);
+	bool choose(char visible_field[][MAT_WIDTH], int height, int width,
+				int bombs, int& x, int& y, bool& guess);
+};
+
+
+class ProbabilityStrategy : public DeterministicStrategy {
+protected:
+	ProbabilityEngine probability;
+
+	bool guess_tile(char visible_field[][MAT_WIDTH], int height,
+					int width, int bombs, int& x, int& y);
+
+public:
+	ProbabilityStrategy();
+	const char* get_name();
+};
+
+
+class EndgameStrategy : public ProbabilityStrategy {
+protected:
+	EndgameSolver endgame;
+
+	bool guess_tile(char visible_field[][MAT_WIDTH], int height,
+					int width, int bombs, int& x, int& y);
+
+public:
+	const char* get_name();
+};
+
+#endif // _STRATEGY_H_
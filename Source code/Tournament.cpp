@@ -0,0 +1,286 @@
+/**
+	Tournament.cpp
+		Compares bot strategies (see 'Strategy.h') without the noise of the
+	boards' luck: every strategy plays the same seeded boards, from the
+	same first reveal, through the game itself (headless), on all cores.
+	The win rate, guesses and moves of every strategy are reported, then
+	every pair of strategies is compared on the same boards: the boards
+	only one of them won, with the p-value of McNemar's test (exact for
+	few such boards), and the mean difference of their guesses.
+
+	Usage: './minesweeper-tournament [-n GAMES] [-t THREADS] [-s SEED]
+	[-d DIFF] [-S STRATEGIES]'
+
+	@author Sergiu Constantinescu
+*/
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include "GameState.h"
+#include "GameSettings.h"
+#include "IOScript.h"
+#include "Strategy.h"
+#include "WorkStealingPool.h"
+#include "Utils.h"
+
+// below this many boards won by only one of two strategies, McNemar's
+// test uses the exact binomial distribution
+#define EXACT_TEST_MAX	50
+
+
+// moves and time of one strategy, gathered by every thread
+struct strategy_stats {
+	uint64_t moves;
+	double seconds;
+
+	strategy_stats() : moves(0), seconds(0.0) {}
+};
+
+// the game objects and the strategies owned by one thread
+struct tournament_worker {
+	GameSettings settings;
+	IOScript io_script;
+	GameState<IOScript> game_state;
+	std::vector<Strategy*> strategies;
+	std::vector<per_thread<strategy_stats> > stats;
+
+	tournament_worker(const std::vector<std::string>& names) :
+		io_script(&settings), game_state(&io_script), stats(names.size()) {
+		for(size_t s = 0; s < names.size(); s ++) {
+			strategies.push_back(Strategy::create(names[s]));
+		}
+	}
+
+	~tournament_worker() {
+		for(size_t s = 0; s < strategies.size(); s ++) {
+			delete strategies[s];
+		}
+	}
+};
+
+// plays the board of the settings' seed from (x, y); returns the moves
+// made, guesses gets the guesses among them
+uint64_t play(GameState<IOScript>& game, GameSettings& settings,
+				Strategy& strategy, uint64_t seed, int x, int y, int& guesses) {
+	uint64_t moves = 1;
+	guesses = 0;
+
+	game.start_game(&settings);
+	strategy.start(seed);
+	game.click(x, y);
+	char (*field)[MAT_WIDTH] = game.get_visible_field();
+	while(!game.is_won() && !game.is_lost()) {
+		bool guess;
+		if(!strategy.choose(field, game.get_height(), game.get_width(),
+							game.get_bombs(), x, y, guess)) {
+			break;
+		}
+		game.click(x, y);
+		moves ++;
+		guesses += guess;
+	}
+	return moves;
+}
+
+// two-sided p-value of McNemar's test, a_only and b_only being the boards
+// won by only one of the two strategies
+double mcnemar(uint64_t a_only, uint64_t b_only) {
+	uint64_t n = a_only + b_only;
+	if(n == 0) {
+		return 1.0;
+	}
+	if(n <= EXACT_TEST_MAX) {
+		// both as likely under the null hypothesis: binomial(n, 1/2) tails
+		uint64_t k = std::min(a_only, b_only);
+		double tail = 0.0;
+		for(uint64_t i = 0; i <= k; i ++) {
+			tail += std::exp(std::lgamma(n + 1.0) - std::lgamma(i + 1.0) -
+								std::lgamma(n - i + 1.0) - n * std::log(2.0));
+		}
+		return std::min(1.0, 2.0 * tail);
+	}
+	// chi-square with one degree of freedom, with continuity correction
+	double d = std::fabs((double)a_only - (double)b_only) - 1.0;
+	double chi2 = std::max(0.0, d) * std::max(0.0, d) / n;
+	return std::erfc(std::sqrt(chi2 / 2.0));
+}
+
+// comma separated names
+std::vector<std::string> parse_names(const char* text) {
+	std::vector<std::string> names;
+	std::istringstream list(text);
+	std::string item;
+	while(std::getline(list, item, ',')) {
+		names.push_back(item);
+	}
+	return names;
+}
+
+void usage() {
+	std::cout << "Usage: './minesweeper-tournament [-n GAMES] [-t THREADS]"
+				<< " [-s SEED] [-d DIFF] [-S STRATEGIES]'" << std::endl;
+	std::cout << "\tGAMES      - boards every strategy plays (default 10000)"
+				<< std::endl;
+	std::cout << "\tTHREADS    - threads to use (default one per core)"
+				<< std::endl;
+	std::cout << "\tSEED       - base seed of the boards (default 1)"
+				<< std::endl;
+	std::cout << "\tDIFF       - 1 novice ... 4 fullscreen master (default 2)"
+				<< std::endl;
+	std::cout << "\tSTRATEGIES - some of naive,deterministic,probability,"
+				<< "endgame (the default)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	uint64_t nr_of_games = 10000;
+	int nr_of_threads = 0;
+	uint64_t base_seed = 1;
+	int diff = 2;
+	std::vector<std::string> names =
+		parse_names("naive,deterministic,probability,endgame");
+
+	for(int i = 1; i < argc; i ++) {
+		std::string arg(argv[i]);
+		if(i + 1 >= argc) {
+			usage();
+			return 1;
+		}
+		if(arg == "-n") {
+			nr_of_games = strtoull(argv[++ i], NULL, 10);
+		} else if(arg == "-t") {
+			nr_of_threads = atoi(argv[++ i]);
+		} else if(arg == "-s") {
+			base_seed = strtoull(argv[++ i], NULL, 10);
+		} else if(arg == "-d") {
+			diff = atoi(argv[++ i]);
+		} else if(arg == "-S") {
+			names = parse_names(argv[++ i]);
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	for(size_t s = 0; s < names.size(); s ++) {
+		Strategy* strategy = Strategy::create(names[s]);
+		if(strategy == NULL) {
+			std::cout << "Unknown strategy '" << names[s] << "'." << std::endl;
+			usage();
+			return 1;
+		}
+		delete strategy;
+	}
+	if(nr_of_games == 0 || names.empty()) {
+		usage();
+		return 1;
+	}
+
+	WorkStealingPool pool(nr_of_threads);
+	std::vector<tournament_worker*> workers;
+	for(int w = 0; w < pool.get_threads(); w ++) {
+		workers.push_back(new tournament_worker(names));
+		workers[w]->settings.set_diff(diff);
+	}
+
+	// the outcome of every board for every strategy, [s][game]
+	size_t nr_of_strategies = names.size();
+	std::vector<std::vector<char> > won(nr_of_strategies,
+										std::vector<char>(nr_of_games, 0));
+	std::vector<std::vector<int> > guesses(nr_of_strategies,
+										std::vector<int>(nr_of_games, 0));
+
+	auto start = std::chrono::steady_clock::now();
+	pool.parallel_for(nr_of_games, 16, [&](int w, size_t game) {
+		tournament_worker& worker = *workers[w];
+		uint64_t seed = splitmix64(base_seed + game);
+		int x = 1 + seed % worker.settings.get_height();
+		int y = 1 + (seed >> 32) % worker.settings.get_width();
+		// a zero seed would mean 'use the time'
+		worker.settings.set_seed(seed | 1);
+
+		for(size_t s = 0; s < nr_of_strategies; s ++) {
+			auto begin = std::chrono::steady_clock::now();
+			worker.stats[s].value.moves += play(worker.game_state, worker.settings,
+											*worker.strategies[s], seed, x, y,
+											guesses[s][game]);
+			worker.stats[s].value.seconds += std::chrono::duration<double>(
+								std::chrono::steady_clock::now() - begin).count();
+			won[s][game] = worker.game_state.is_won();
+		}
+	});
+	double elapsed = std::chrono::duration<double>(
+						std::chrono::steady_clock::now() - start).count();
+
+	char line[160];
+	GameSettings& settings = workers[0]->settings;
+	std::cout << nr_of_games << " boards of " << settings.get_height() << "x"
+				<< settings.get_width() << " with " << settings.get_bombs()
+				<< " bombs (" << pool.get_threads() << " threads, "
+				<< elapsed << " s), 95% intervals" << std::endl;
+	std::cout << "Strategy          Won %       (interval)       Guesses/game"
+				<< "  Moves/game  Moves/s/thread" << std::endl;
+	for(size_t s = 0; s < nr_of_strategies; s ++) {
+		uint64_t wins = 0;
+		double sum = 0.0;
+		double sum_sq = 0.0;
+		uint64_t moves = 0;
+		double seconds = 0.0;
+		for(uint64_t game = 0; game < nr_of_games; game ++) {
+			wins += won[s][game];
+			sum += guesses[s][game];
+			sum_sq += (double)guesses[s][game] * guesses[s][game];
+		}
+		for(size_t w = 0; w < workers.size(); w ++) {
+			moves += workers[w]->stats[s].value.moves;
+			seconds += workers[w]->stats[s].value.seconds;
+		}
+		double low, high;
+		wilson_interval(wins, nr_of_games, low, high);
+		snprintf(line, sizeof(line),
+					"%-14s %7.2f%%  (%6.2f - %6.2f)  %6.2f +- %-5.2f %9.2f %13.0f",
+					names[s].c_str(), 100.0 * wins / nr_of_games,
+					100.0 * low, 100.0 * high, sum / nr_of_games,
+					mean_error(sum, sum_sq, nr_of_games),
+					(double)moves / nr_of_games, moves / seconds);
+		std::cout << line << std::endl;
+	}
+
+	if(nr_of_strategies > 1) {
+		std::cout << std::endl << "Paired on the same boards: boards won by"
+					<< " only one, McNemar's p, guesses A - B" << std::endl;
+		std::cout << "A              B                 A only    B only"
+					<< "   p-value      Guesses A - B" << std::endl;
+	}
+	for(size_t a = 0; a < nr_of_strategies; a ++) {
+		for(size_t b = a + 1; b < nr_of_strategies; b ++) {
+			uint64_t a_only = 0;
+			uint64_t b_only = 0;
+			double sum = 0.0;
+			double sum_sq = 0.0;
+			for(uint64_t game = 0; game < nr_of_games; game ++) {
+				a_only += won[a][game] && !won[b][game];
+				b_only += !won[a][game] && won[b][game];
+				double d = guesses[a][game] - guesses[b][game];
+				sum += d;
+				sum_sq += d * d;
+			}
+			snprintf(line, sizeof(line),
+						"%-14s %-14s %9llu %9llu %9.3g   %+7.3f +- %.3f",
+						names[a].c_str(), names[b].c_str(),
+						(unsigned long long)a_only, (unsigned long long)b_only,
+						mcnemar(a_only, b_only), sum / nr_of_games,
+						mean_error(sum, sum_sq, nr_of_games));
+			std::cout << line << std::endl;
+		}
+	}
+
+	for(size_t w = 0; w < workers.size(); w ++) {
+		delete workers[w];
+	}
+	return 0;
+}
@@ -0,0 +1,44 @@
+/**
+	TranspositionTable.cpp
+		Contains the implementation of the functions declared in
+	'TranspositionTable.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include "TranspositionTable.h"
+
+// set in the data of the used entries
+#define ENTRY_USED	(1ULL << 32)
+
+
+TranspositionTable::TranspositionTable(int bits) :
+	entries((size_t)1 << bits),
+	mask(((uint64_t)1 << bits) - 1) {
+	clear();
+}
+
+// the low bits of the keys are as random as the high ones
+bool TranspositionTable::probe(uint64_t key, uint32_t& value) const {
+	const entry& e = entries[key & mask];
+	uint64_t data = e.data.load(std::memory_order_relaxed);
+	uint64_t check = e.check.load(std::memory_order_relaxed);
+	if(!(data & ENTRY_USED) || (check ^ data) != key) {
+		return false;
+	}
+	value = (uint32_t)data;
+	return true;
+}
+
+void TranspositionTable::store(uint64_t key, uint32_t value) {
+	entry& e = entries[key & mask];
+	uint64_t data = ENTRY_USED | value;
+	e.data.store(data, std::memory_order_relaxed);
+	e.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+	for(size_t k = 0; k < entries.size(); k ++) {
+		entries[k].data.store(0, std::memory_order_relaxed);
+		entries[k].check.store(0, std::memory_order_relaxed);
+	}
+}
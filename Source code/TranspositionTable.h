@@ -0,0 +1,45 @@
+/**
+	TranspositionTable.h
+		Remembers a 32 bit answer for every position (by its Zobrist key),
+	so a search or a player meeting a position again, in any thread, looks
+	it up instead of working it out. The table has a fixed number of
+	entries and a new answer replaces the one in its slot. It takes no
+	locks: an entry stores the answer and the key mixed with it, and a
+	probe only trusts an entry whose two words agree, so an entry torn by
+	two threads writing at once reads as a miss.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _TRANSPOSITIONTABLE_H_
+#define _TRANSPOSITIONTABLE_H_
+
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+
+class TranspositionTable {
+private:
+	struct entry {
+		// key ^ data
+		std::atomic<uint64_t> check;
+		// the answer, with a mark in the upper half telling it from
+		// the empty entries
+		std::atomic<uint64_t> data;
+	};
+
+	std::vector<entry> entries;
+	uint64_t mask;
+
+public:
+	// the table has 2^bits entries, of 16 bytes each
+	TranspositionTable(int bits);
+
+	// true and the answer stored for key, if it is still there
+	bool probe(uint64_t key, uint32_t& value) const;
+	void store(uint64_t key, uint32_t value);
+	void clear();
+};
+
+#endif // _TRANSPOSITIONTABLE_H_
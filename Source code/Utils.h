@@ -7,21 +7,34 @@
 #ifndef _UTILS_H_
 #define _UTILS_H_
 
+#include <cmath>
 #include <string>
 #include <vector>
+#include <stdint.h>
 
 #define LINE01 "==================================="
 #define LINE02 "                        M I N E S W E E P E R"
 
 // max dimensions of the game board, counting the borders too
-#define MAT_HEIGHT  17
-#define MAT_WIDTH	71
-// customizable game board limits
-#define MAX_HEIGHT 	14 // 22
+#define MAT_HEIGHT  101
+#define MAT_WIDTH	201
+// customizable game board limits (boards larger than the terminal
+// are scrolled around the cursor)
+#define MAX_HEIGHT 	99
 #define MIN_HEIGHT	3
-#define MAX_WIDTH 	68 // 52
-#define MIN_WIDTH	3
+#define MAX_WIDTH 	199
+// a board must have room for bombs outside the 3x3 block that
+// the first reveal opens
+#define MIN_WIDTH	4
 #define MIN_BOMBS	1
+// bombs may cover at most this part of the board
+#define MAX_DENSITY	0.75
+// past this part, boards that need no guessing are too rare to be found
+// in time, and are not looked for
+#define NO_GUESS_MAX_DENSITY	0.25
+
+// presets file read at startup, if it exists (see 'minesweeper-calibrate')
+#define PRESETS_FILE	"presets.txt"
 
 // symbols used on or 'under' the game board
 #define WALL 	'#'
@@ -31,6 +44,43 @@
 #define EMPTYD	'.'
 #define GOODFT	'o'
 
+// mixes a 64 bit value (splitmix64), used to derive independent seeds,
+// e.g. one for every simulated game
+inline uint64_t splitmix64(uint64_t x) {
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+// normal quantile of the 95% confidence intervals
+#define Z_95	1.96
+
+// 95% Wilson score interval of wins out of games (games > 0), good
+// even near 0% and 100%
+inline void wilson_interval(uint64_t wins, uint64_t games,
+							double& low, double& high) {
+	double n = games;
+	double p = wins / n;
+	double z2 = Z_95 * Z_95;
+	double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+	double spread = Z_95 * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n))
+					/ (1 + z2 / n);
+	low = center - spread;
+	high = center + spread;
+}
+
+// half the width of the 95% interval of a mean, from the sum and the sum
+// of squares of n values
+inline double mean_error(double sum, double sum_sq, uint64_t n) {
+	if(n < 2) {
+		return 0.0;
+	}
+	double mean = sum / n;
+	double variance = (sum_sq - n * mean * mean) / (n - 1);
+	return variance > 0.0 ? Z_95 * std::sqrt(variance / n) : 0.0;
+}
+
 const std::vector<std::string> rules{
 "   The game board is represented by tiles that you can check.",
 "   There are 3 types of tiles: bombs, numbers and empty spaces.",
@@ -41,8 +91,10 @@ const std::vector<std::string> rules{
 " is an empty tile and is safe to reveal. You can mark suspicious",
 " tiles with flags.",
 "   Controls: w/a/s/d - move the cursor ('+') around,",
-"             space   - reveal tile,",
-"             e       - drop/take flag ('F'),",
+"             space   - reveal tile, e - drop/take flag ('F'),",
+"             n/b/f   - next/previous/closest unsolved tile,",
+"             h/r     - go to the safest tile / reveal the safe ones,",
+"             c       - estimate the chance to win from here,",
 "             q       - quit.",
 };
 
@@ -0,0 +1,157 @@
+/**
+	WinEstimator.cpp
+		Contains the implementation of the functions declared in
+	'WinEstimator.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <cstring>
+#include "WinEstimator.h"
+
+
+WinEstimator::WinEstimator(int threads) :
+	nr_of_threads(threads),
+	table(NULL),
+	cancelled(false),
+	running(false),
+	failed(false),
+	playouts(0),
+	wins(0),
+	height(0),
+	width(0),
+	bombs(0),
+	cursor_x(1),
+	cursor_y(1),
+	seed(0) {
+	if(nr_of_threads <= 0) {
+		nr_of_threads = std::thread::hardware_concurrency();
+	}
+	if(nr_of_threads <= 0) {
+		nr_of_threads = 1;
+	}
+	probability.set_sampling(true);
+	probability.set_cancel(&cancelled);
+	probability.set_time_limit(WIN_BUDGET_MS);
+}
+
+WinEstimator::~WinEstimator() {
+	cancel();
+	for(size_t w = 0; w < workers.size(); w ++) {
+		delete workers[w];
+	}
+	delete table;
+}
+
+void WinEstimator::request(char visible_field[][MAT_WIDTH], int height,
+							int width, int bombs, int x, int y, uint64_t seed) {
+	cancel();
+
+	for(int i = 0; i < height + 2; i ++) {
+		memcpy(field[i], visible_field[i], width + 2);
+	}
+	this->height = height;
+	this->width = width;
+	this->bombs = bombs;
+	cursor_x = x;
+	cursor_y = y;
+	this->seed = seed;
+
+	// the workers are large, most games never ask for an estimate
+	if(table == NULL) {
+		table = new TranspositionTable(WIN_TABLE_BITS);
+	}
+	while((int)workers.size() < nr_of_threads) {
+		workers.push_back(new worker());
+		workers.back()->player.set_table(table);
+	}
+	cancelled = false;
+	failed = false;
+	playouts = 0;
+	wins = 0;
+	running = true;
+	deadline = std::chrono::steady_clock::now() +
+				std::chrono::milliseconds(WIN_BUDGET_MS);
+	controller = std::thread(&WinEstimator::run, this);
+}
+
+void WinEstimator::cancel() {
+	cancelled = true;
+	if(controller.joinable()) {
+		controller.join();
+	}
+	running = false;
+}
+
+void WinEstimator::wait() {
+	if(controller.joinable()) {
+		controller.join();
+	}
+}
+
+WinEstimator::estimate WinEstimator::get() {
+	estimate e;
+	// the estimate is marked as done after its last playout, and a playout
+	// is counted before its win: reading them in reverse order, a finished
+	// estimate is always complete and the wins never outnumber the playouts
+	e.running = running;
+	e.failed = failed;
+	e.wins = wins;
+	e.playouts = playouts;
+	e.chance = 0.0;
+	e.low = 0.0;
+	e.high = 1.0;
+	if(e.playouts > 0) {
+		e.chance = (double)e.wins / e.playouts;
+		wilson_interval(e.wins, e.playouts, e.low, e.high);
+	}
+	return e;
+}
+
+// the probabilities are computed once, then all the threads play
+void WinEstimator::run() {
+	if(!probability.compute(field, height, width, bombs)) {
+		failed = true;
+		running = false;
+		return;
+	}
+
+	std::vector<std::thread> helpers;
+	for(int w = 1; w < nr_of_threads; w ++) {
+		helpers.push_back(std::thread(&WinEstimator::work, this, w));
+	}
+	work(0);
+	for(size_t w = 0; w < helpers.size(); w ++) {
+		helpers[w].join();
+	}
+	running = false;
+}
+
+bool WinEstimator::enough() {
+	uint64_t n = playouts;
+	if(cancelled || n >= WIN_MAX_PLAYOUTS ||
+		std::chrono::steady_clock::now() > deadline) {
+		return true;
+	}
+	if(n < WIN_MIN_PLAYOUTS) {
+		return false;
+	}
+	double low, high;
+	wilson_interval(wins, n, low, high);
+	return (high - low) / 2 <= WIN_TARGET_ERROR;
+}
+
+void WinEstimator::work(int w) {
+	worker& own = *workers[w];
+	uint64_t state = splitmix64(seed + w);
+
+	while(!enough()) {
+		probability.sample(state, own.hidden);
+		AutoPlayer::result res = own.player.play_from(own.hidden, field,
+											height, width, bombs,
+											cursor_x, cursor_y);
+		playouts ++;
+		if(res.won) {
+			wins ++;
+		}
+	}
+}
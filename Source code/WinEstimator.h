@@ -0,0 +1,103 @@
+/**
+	WinEstimator.h
+		Estimates the chance to win from the current position by Monte
+	Carlo, on threads of its own. The exact probabilities are computed once
+	with sampling on, then every thread draws whole boards that agree with
+	what the player sees, each with its true probability under the total of
+	bombs, and plays them to the end with the solver and the safest guesses.
+	The share of won playouts and its 95% interval can be read at any time
+	and tighten as the playouts come in, until the interval is narrow
+	enough, the time budget is spent or the estimate is cancelled. The
+	threads share their guesses through a transposition table: all the
+	playouts start from the same position and many meet the same ones
+	after it, so most guesses are looked up instead of worked out.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _WINESTIMATOR_H_
+#define _WINESTIMATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include "AutoPlayer.h"
+#include "Probability.h"
+#include "TranspositionTable.h"
+#include "Utils.h"
+
+// the longest an estimate runs, the most playouts it makes, and the
+// half width of the 95% interval it stops at (after a few playouts)
+#define WIN_BUDGET_MS		10000
+#define WIN_MAX_PLAYOUTS	200000
+#define WIN_TARGET_ERROR	0.005
+#define WIN_MIN_PLAYOUTS	100
+// the guesses shared by the playouts, 2^18 entries (4 MB)
+#define WIN_TABLE_BITS		18
+
+
+class WinEstimator {
+public:
+	struct estimate {
+		uint64_t playouts;
+		uint64_t wins;
+		// chance to win and its 95% interval
+		double chance;
+		double low;
+		double high;
+		bool running;
+		// the position had too many layouts to be sampled in time
+		bool failed;
+	};
+
+private:
+	// the board drawn and played by one thread
+	struct worker {
+		char hidden[MAT_HEIGHT][MAT_WIDTH];
+		AutoPlayer player;
+	};
+
+	int nr_of_threads;
+	std::vector<worker*> workers;
+	// kept across the estimates, the keys tell the positions apart
+	TranspositionTable* table;
+	std::thread controller;
+	std::atomic<bool> cancelled;
+	std::atomic<bool> running;
+	std::atomic<bool> failed;
+	std::atomic<uint64_t> playouts;
+	std::atomic<uint64_t> wins;
+	std::chrono::steady_clock::time_point deadline;
+
+	// the position being estimated
+	char field[MAT_HEIGHT][MAT_WIDTH];
+	int height;
+	int width;
+	int bombs;
+	int cursor_x;
+	int cursor_y;
+	uint64_t seed;
+	ProbabilityEngine probability;
+
+	void run();
+	void work(int w);
+	bool enough();
+
+public:
+	// 0 threads means one for every core
+	WinEstimator(int threads);
+	~WinEstimator();
+
+	// starts estimating the position of visible_field, cancelling the
+	// estimate before it; the playouts guess closest to (x, y) first
+	void request(char visible_field[][MAT_WIDTH], int height, int width,
+					int bombs, int x, int y, uint64_t seed);
+	// stops the estimate, keeping what it found so far
+	void cancel();
+	// blocks until the estimate is done
+	void wait();
+	estimate get();
+};
+
+#endif // _WINESTIMATOR_H_
@@ -0,0 +1,105 @@
+/**
+	WorkStealingPool.cpp
+		Contains the implementation of the functions declared in
+	'WorkStealingPool.h'.
+
+	@author Sergiu Constantinescu
+*/
+#include <thread>
+#include "WorkStealingPool.h"
+
+
+WorkStealingPool::WorkStealingPool(int threads) :
+	nr_of_threads(threads),
+	remaining(0) {
+	if(nr_of_threads <= 0) {
+		nr_of_threads = std::thread::hardware_concurrency();
+	}
+	if(nr_of_threads <= 0) {
+		nr_of_threads = 1;
+	}
+	queues = std::vector<worker_queue>(nr_of_threads);
+}
+
+int WorkStealingPool::get_threads() {
+	return nr_of_threads;
+}
+
+void WorkStealingPool::parallel_for(size_t n, size_t grain,
+						const std::function<void(int, size_t)>& body) {
+	if(n == 0) {
+		return;
+	}
+	if(grain == 0) {
+		grain = 1;
+	}
+
+	remaining = n;
+	range all = {0, n};
+	push_local(0, all);
+
+	// the calling thread is worker 0
+	std::vector<std::thread> threads;
+	for(int w = 1; w < nr_of_threads; w ++) {
+		threads.push_back(std::thread(&WorkStealingPool::work,
+										this, w, grain, std::cref(body)));
+	}
+	work(0, grain, body);
+	for(size_t i = 0; i < threads.size(); i ++) {
+		threads[i].join();
+	}
+}
+
+void WorkStealingPool::work(int worker, size_t grain,
+							const std::function<void(int, size_t)>& body) {
+	range r;
+
+	while(remaining > 0) {
+		if(!pop_local(worker, r) && !steal(worker, r)) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		// the upper halves stay available to the other threads
+		while(r.end - r.begin > grain) {
+			range upper = {r.begin + (r.end - r.begin) / 2, r.end};
+			r.end = upper.begin;
+			push_local(worker, upper);
+		}
+
+		for(size_t i = r.begin; i < r.end; i ++) {
+			body(worker, i);
+		}
+		remaining -= r.end - r.begin;
+	}
+}
+
+void WorkStealingPool::push_local(int worker, range r) {
+	std::lock_guard<std::mutex> guard(queues[worker].lock);
+	queues[worker].ranges.push_back(r);
+}
+
+// the owner takes the most recent (smallest) range
+bool WorkStealingPool::pop_local(int worker, range& r) {
+	std::lock_guard<std::mutex> guard(queues[worker].lock);
+	if(queues[worker].ranges.empty()) {
+		return false;
+	}
+	r = queues[worker].ranges.back();
+	queues[worker].ranges.pop_back();
+	return true;
+}
+
+// thieves take the oldest (largest) range of the first busy worker
+bool WorkStealingPool::steal(int worker, range& r) {
+	for(int i = 1; i < nr_of_threads; i ++) {
+		int victim = (worker + i) % nr_of_threads;
+		std::lock_guard<std::mutex> guard(queues[victim].lock);
+		if(!queues[victim].ranges.empty()) {
+			r = queues[victim].ranges.front();
+			queues[victim].ranges.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
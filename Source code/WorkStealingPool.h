@@ -0,0 +1,67 @@
+/**
+	WorkStealingPool.h
+		Runs a loop over many independent items (e.g. simulated games) on
+	several threads. Every thread owns a queue of index ranges; it splits
+	the ranges it takes, keeps working on the lower halves and leaves the
+	upper halves in its queue, from where idle threads steal them.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _WORKSTEALINGPOOL_H_
+#define _WORKSTEALINGPOOL_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// bytes of a cache line, the unit the cores pass between them
+#define CACHE_LINE	64
+
+// a value only one thread writes to, e.g. its statistics; a whole cache
+// line of padding follows it, so no two of them ever share a line,
+// wherever they are allocated (the C++11 allocators ignore alignas)
+template <class T>
+struct per_thread {
+	T value;
+	char padding[CACHE_LINE];
+};
+
+
+class WorkStealingPool {
+private:
+	// items [begin, end) of the loop
+	struct range {
+		size_t begin;
+		size_t end;
+	};
+	struct worker_queue {
+		std::mutex lock;
+		std::deque<range> ranges;
+	};
+
+	int nr_of_threads;
+	std::vector<worker_queue> queues;
+	// items not finished yet
+	std::atomic<size_t> remaining;
+
+	void work(int worker, size_t grain,
+				const std::function<void(int, size_t)>& body);
+	void push_local(int worker, range r);
+	bool pop_local(int worker, range& r);
+	bool steal(int worker, range& r);
+
+public:
+	// 0 threads means one for every core
+	WorkStealingPool(int threads);
+
+	int get_threads();
+	// calls body(worker, i) for every i in [0, n), where worker is the
+	// index of the calling thread (0 to get_threads() - 1); ranges are not
+	// split below grain items; returns after all the items were done
+	void parallel_for(size_t n, size_t grain,
+						const std::function<void(int, size_t)>& body);
+};
+
+#endif // _WORKSTEALINGPOOL_H_
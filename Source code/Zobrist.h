@@ -0,0 +1,58 @@
+/**
+	Zobrist.h
+		64 bit Zobrist keys of board positions. Every tile state has a random
+	key and a position is the exclusive or of the keys of its tiles, so a
+	reveal updates it in constant time, whatever the order the tiles were
+	revealed in. The keys are drawn by splitmix64 from the tile and its
+	symbol instead of read from a table; hidden tiles have no key, so a
+	position costs nothing until it is played. A position is only what the
+	board shows: flags are the player's opinion and are read as hidden
+	tiles. The keys are kept by the players of whole boards (AutoPlayer, at
+	every reveal) and the endgame search, for their transposition tables;
+	the game itself keeps none.
+
+	@author Sergiu Constantinescu
+*/
+#ifndef _ZOBRIST_H_
+#define _ZOBRIST_H_
+
+#include <stdint.h>
+#include "Utils.h"
+
+// keeps the keys apart from the other uses of splitmix64
+#define ZOBRIST_SALT	0x6a09e667f3bcc908ULL
+
+// key of tile (x, y) showing ch, 0 for the hidden and flagged tiles
+inline uint64_t zobrist_tile(int x, int y, char ch) {
+	if(ch == EMPTYH || ch == FLAGT) {
+		return 0;
+	}
+	uint64_t t = (uint64_t)(x * MAT_WIDTH + y);
+	return splitmix64((t << 8 | (unsigned char)ch) ^ ZOBRIST_SALT);
+}
+
+// key of a cursor on (x, y), for answers that depend on where it is
+inline uint64_t zobrist_cursor(int x, int y) {
+	uint64_t t = (uint64_t)(x * MAT_WIDTH + y);
+	return splitmix64((t << 8 | 0xff) ^ ZOBRIST_SALT);
+}
+
+// key of the board itself, so equal tiles on different boards differ
+inline uint64_t zobrist_board(int height, int width, int bombs) {
+	uint64_t size = (uint64_t)height << 40 | (uint64_t)width << 20 | bombs;
+	return splitmix64(splitmix64(size) ^ ZOBRIST_SALT);
+}
+
+// key of the whole height x width position in field
+inline uint64_t zobrist_position(const char field[][MAT_WIDTH],
+									int height, int width, int bombs) {
+	uint64_t key = zobrist_board(height, width, bombs);
+	for(int i = 1; i <= height; i ++) {
+		for(int j = 1; j <= width; j ++) {
+			key ^= zobrist_tile(i, j, field[i][j]);
+		}
+	}
+	return key;
+}
+
+#endif // _ZOBRIST_H_
@@ -7,11 +7,16 @@
 */
 #include <iostream>
 #include <string>
+#include <cstdio>
+#include <cstdlib>
 #include <ncurses.h>
 #include "GameState.h"
 #include "GameSettings.h"
+#include "BoardGenerator.h"
 #include "MainMenu.h"
 #include "IOText.h"
+#include "IOScript.h"
+#include "Utils.h"
 
 #ifdef __WIN32
 	// wip for version 1.1
@@ -28,6 +33,86 @@ void usage() {
 	std::cout << "[GRAPHICS MODE] :" << std::endl;
 	std::cout << "\t1 - Text mode" << std::endl;
 	std::cout << "\t2 - Fancy graphics (default)" << std::endl;	
+	std::cout << "\t3 - Text mode redrawn in place (ANSI terminals)" << std::endl;
+	std::cout << "   or: './Minesweeper --script FILE [--seed N] [--diff D]"
+				<< " [--no-guess] [--3bv MIN:MAX]" << std::endl;
+	std::cout << "\t[--presets FILE]'" << std::endl;
+	std::cout << "\tplays the keys in FILE headless, on the boards generated"
+				<< " from seed N," << std::endl;
+	std::cout << "\tat difficulty D (1 - novice ... 4 - fullscreen master)"
+				<< std::endl;
+	std::cout << "\t--no-guess only makes boards solvable without guessing"
+				<< std::endl;
+	std::cout << "\t--3bv only makes boards with a 3BV from MIN to MAX"
+				<< " (0 for no limit)" << std::endl;
+	std::cout << "\t--presets reads the difficulty presets from FILE"
+				<< " (default '" << PRESETS_FILE << "')" << std::endl;
+}
+
+// plays a whole script without displaying anything, then prints the results
+int run_script(int argc, char* argv[], GameSettings* settings) {
+	const char* path = NULL;
+	// applied last, changing the difficulty drops the range
+	int min_3bv = 0;
+	int max_3bv = 0;
+
+	for(int i = 1; i < argc; i ++) {
+		std::string arg(argv[i]);
+		if(arg == "--script" && i + 1 < argc) {
+			path = argv[++ i];
+		} else if(arg == "--seed" && i + 1 < argc) {
+			settings->set_seed(strtoull(argv[++ i], NULL, 10));
+		} else if(arg == "--presets" && i + 1 < argc) {
+			if(!settings->load_presets(argv[++ i])) {
+				std::cout << "Could not read the presets." << std::endl;
+				return 1;
+			}
+		} else if(arg == "--diff" && i + 1 < argc) {
+			settings->set_diff(atoi(argv[++ i]));
+		} else if(arg == "--no-guess") {
+			settings->set_no_guess(true);
+		} else if(arg == "--3bv" && i + 1 < argc &&
+					sscanf(argv[i + 1], "%d:%d", &min_3bv, &max_3bv) == 2) {
+			i ++;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+
+	settings->set_3bv_range(min_3bv, max_3bv);
+	// the boards asked for must be found in time, see 'BoardGenerator.h'
+	if(settings->get_no_guess() && !settings->no_guess_possible()) {
+		std::cout << "No-guess boards need at most "
+					<< (int)(NO_GUESS_MAX_DENSITY * 100) << "% bombs." << std::endl;
+		return 1;
+	}
+	if(min_3bv > 0 || max_3bv > 0) {
+		BoardGenerator sampler(1);
+		int low, high;
+		sampler.sample_3bv(settings->get_height(), settings->get_width(),
+							settings->get_bombs(), 1, low, high);
+		if(min_3bv > high || (max_3bv > 0 && max_3bv < low)) {
+			std::cout << "Boards of this size have a 3BV from about " << low
+						<< " to " << high << "." << std::endl;
+			return 1;
+		}
+	}
+
+	IOScript io_script(settings);
+	if(path == NULL || !io_script.load_file(path)) {
+		std::cout << "Could not read the script." << std::endl;
+		return 1;
+	}
+
+	GameState<IOScript> game_state(&io_script);
+	game_state.game_loop(settings);
+
+	std::cout << "Won " << io_script.get_games_won()
+				<< ", lost " << io_script.get_games_lost()
+				<< ", solved " << io_script.get_last_percent() << "%."
+				<< std::endl;
+	return 0;
 }
 
 int main(int argc, char* argv[]) {
@@ -36,19 +121,32 @@ int main(int argc, char* argv[]) {
 	bool game_running = true;
 	// false if game is started in Text mode
 	bool io_mode_color = true;
+	// true if the text mode may use ANSI escape sequences
+	bool io_mode_ansi = false;
 
 	GameSettings *settings = new GameSettings();
+	// the hard-coded presets are kept if there is no presets file
+	settings->load_presets(PRESETS_FILE);
+
+	if(argc > 1 && std::string(argv[1]).compare(0, 2, "--") == 0) {
+		int ret = run_script(argc, argv, settings);
+		delete settings;
+		return ret;
+	}
 
 	if(argc == 2) {
 		if(std::string(argv[1]) == "1") {
 			io_mode_color = false;
+		} else if(std::string(argv[1]) == "3") {
+			io_mode_color = false;
+			io_mode_ansi = true;
 		} else if (std::string(argv[1]) != "2") {
 			usage();
 			return 0;
 		}
 	}
 
-	IOText* io_text = new IOText(settings);
+	IOText* io_text = new IOText(settings, io_mode_ansi);
 	GRAPHICS* io_color = new GRAPHICS(settings);
 
 	// object containing the game logic
@@ -87,7 +185,6 @@ int main(int argc, char* argv[]) {
 	delete io_text;
 	delete io_color;
 	delete settings;
-	endwin();
 
 	return 0;
 }